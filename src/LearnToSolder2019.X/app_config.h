@@ -0,0 +1,196 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Build time configuration. Each option can be overridden from the compiler
+ * command line (for example -DPWM_ENGINE=PWM_ENGINE_COUNTER) without editing
+ * this file.
+ */
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/* How RunTMR0 generates the LED PWM. The counter and edge engines produce 256
+ * step frames with one step per 128 instruction cycles (32uS). Every engine
+ * takes the same 0 to 255 LEDBrightness values.
+ *
+ * PWM_ENGINE_COUNTER - TMR0 interrupts on every step and each LED is compared
+ *                      against a counter. 256 interrupts per frame.
+ * PWM_ENGINE_EDGE    - The brightness values are sorted once per frame and
+ *                      TMR0 is loaded to interrupt only when an LED has to
+ *                      change. At most 6 interrupts per frame.
+ * PWM_ENGINE_BAM     - Bit angle modulation: each bit of the brightness
+ *                      gets a slot weighted by its power of two. Bits 0-2
+ *                      are timed inside one interrupt, so a frame is always
+ *                      6 interrupts, and the frame rate is set by
+ *                      BAM_UNIT_CYCLES instead of being fixed.
+ * PWM_ENGINE_DITHER  - Like the counter engine, but with only DITHER_STEPS
+ *                      steps per frame. The part of each brightness too fine
+ *                      for those steps is carried from frame to frame
+ *                      (sigma-delta), so the average over a few frames is
+ *                      still the full 8 bit level.
+ */
+#define PWM_ENGINE_COUNTER    0
+#define PWM_ENGINE_EDGE       1
+#define PWM_ENGINE_BAM        2
+#define PWM_ENGINE_DITHER     3
+
+#ifndef PWM_ENGINE
+#define PWM_ENGINE            PWM_ENGINE_EDGE
+#endif
+
+/* Length of the bit 0 slot in instruction cycles when PWM_ENGINE_BAM is used.
+ * This is the TMR0 prescale, so it must be 32, 64 or 128. A frame is 255
+ * units long: 32 gives about 490 Hz, 128 gives the same ~122 Hz as the other
+ * engines.
+ */
+#ifndef BAM_UNIT_CYCLES
+#define BAM_UNIT_CYCLES       32
+#endif
+
+/* Steps per frame and frames per second when PWM_ENGINE_DITHER is used, which
+ * interrupts DITHER_STEPS * DITHER_FRAME_HZ times a second. DITHER_STEPS can
+ * be 2 to 128. Fewer steps means fewer interrupts, but a dim LED is then made
+ * up of longer runs of frames, and can be seen to flicker at low frame rates.
+ * Each step must come out as a whole number of TMR0 counts.
+ */
+#ifndef DITHER_STEPS
+#define DITHER_STEPS          16
+#endif
+#ifndef DITHER_FRAME_HZ
+#define DITHER_FRAME_HZ       125
+#endif
+
+// Instruction cycles in one dither step (needs _XTAL_FREQ from mcc.h)
+#define DITHER_STEP_CYCLES    ((_XTAL_FREQ / 4UL) / (1UL * DITHER_STEPS * DITHER_FRAME_HZ))
+
+/* Drive D1-D3 from the 16 bit hardware PWM modules instead of RunTMR0 (PWM2 on
+ * RA0, PWM1 on RA1, PWM3 on RA2, all on their default APFCON pins). They keep
+ * taking their brightness from LEDBrightness, copied over at the start of
+ * each software PWM frame, and the software PWM engine only drives D4 and D5.
+ */
+#ifndef LED_HW_PWM
+#define LED_HW_PWM            1
+#endif
+
+/* Stagger the LEDs within each PWM frame instead of turning them all on at
+ * its start. Each LED turns on where the one before it turned off, so no two
+ * are lit together until their brightness adds up to more than a frame, and
+ * the peak current drawn from the coin cell goes down. Applies to the counter,
+ * edge and dither engines and to the hardware PWM modules, which run one
+ * after another within their own period. BAM frames are not staggered.
+ */
+#ifndef LED_STAGGER
+#define LED_STAGGER           1
+#endif
+
+/* Service every pending interrupt source in each INTERRUPT_InterruptManager
+ * entry, TMR0 then IOC then Timer2. With 0 it services only the first one
+ * pending, and the others wait for the interrupt to be taken again. Each entry
+ * then costs a few cycles less, but the button's IOC waits behind every TMR0
+ * interrupt that is pending alongside it.
+ */
+#ifndef ISR_SERVICE_ALL
+#define ISR_SERVICE_ALL       1
+#endif
+
+/* Bind the interrupt handlers at build time instead of through the function
+ * pointers that TMR0_SetInterruptHandler(), TMR2_SetInterruptHandler() and
+ * IOCAFx_SetInterruptHandler() set. INTERRUPT_InterruptManager then does the
+ * work of TMR0_ISR, TMR2_ISR and PIN_MANAGER_IOC itself and calls the
+ * ISR_..._HANDLER functions below directly, which saves two calls, a null test
+ * and an indirect call on every interrupt. The handlers are not inlined into
+ * the interrupt function: they live in main.c, so each is still one direct
+ * call away. The setters still build, but have no effect. INTERRUPT_Profile
+ * in a build with ISR_PROFILE shows the difference on the chip, and the host
+ * simulator reports it from its cycle model.
+ */
+#ifndef ISR_STATIC_DISPATCH
+#define ISR_STATIC_DISPATCH   0
+#endif
+
+// Handlers called by ISR_STATIC_DISPATCH. ButtonChanged is bound to the
+// button's IOCAF3 by default, as the main loop needs it to see the button.
+// Leave ISR_IOCAF2_HANDLER undefined for none.
+#ifndef ISR_TMR0_HANDLER
+#define ISR_TMR0_HANDLER      RunTMR0
+#endif
+#ifndef ISR_TMR2_HANDLER
+#define ISR_TMR2_HANDLER      RunOneMSTasks
+#endif
+#ifndef ISR_IOCAF3_HANDLER
+#define ISR_IOCAF3_HANDLER    ButtonChanged
+#endif
+
+/* Let SetTimerCallback() give each software timer a function for the ISR to
+ * call when it expires. Off by default, as every timer is polled with
+ * TimerExpired() and a callback test adds to each expiry in the interrupt.
+ */
+#ifndef TIMER_CALLBACKS
+#define TIMER_CALLBACKS       0
+#endif
+
+/* Let mainline register a function with SetLEDFrameHandler() for the ISR to
+ * call each time it starts showing a newly committed LED frame, so the next
+ * one can be drawn while this one is on. Off by default, as nothing uses it
+ * yet and it adds an indirect call to the interrupt.
+ */
+#ifndef LED_FRAME_HANDLER
+#define LED_FRAME_HANDLER     0
+#endif
+
+/* The show in pattern_shows.txt that a press of the button plays, counting
+ * from 0. With PATTERN_SHOW_CYCLE, each press plays the next show instead,
+ * going back to the first after the last.
+ */
+#ifndef PATTERN_SHOW
+#define PATTERN_SHOW          0
+#endif
+#ifndef PATTERN_SHOW_CYCLE
+#define PATTERN_SHOW_CYCLE    0
+#endif
+
+/* Sleep in the main loop's wait for its next event whenever RunTMR0 has no LED
+ * lit, instead of spinning at full speed. TMR0 and Timer2 stop in SLEEP, so
+ * the watchdog wakes the part to count off the time to the next software
+ * timer, and a button edge wakes it at once. The PWM modules are clocked from
+ * LFINTOSC, which keeps running in SLEEP, so D1-D3 stay lit. With 0 the main
+ * loop still only runs when something happens, but waits awake. Needs the
+ * software controlled watchdog, which mcc.c selects in the configuration bits.
+ */
+#ifndef IDLE_SLEEP
+#define IDLE_SLEEP            1
+#endif
+
+/* Run from HFINTOSC at 4MHz whenever no pattern is playing and the button is
+ * up, and go back to 16MHz on the first edge of a press. Timer2's prescaler
+ * follows the clock, so its 1ms tick is unchanged. TMR0 is left to count
+ * instruction cycles, so the PWM frames get longer while nothing is lit.
+ * Delays through DelayMs() in main.c are timed for whichever clock is running.
+ * Any slower, and the longest RunTMR0 frame builds hold off the 1ms tick for
+ * more than a millisecond.
+ */
+#ifndef CLOCK_GOVERNOR
+#define CLOCK_GOVERNOR        1
+#endif
+
+/* How the button is debounced.
+ *
+ * INPUT_DEBOUNCE_IOC      - ButtonChanged stamps each edge from the IOC
+ *                           interrupt, and the button takes its new state
+ *                           once BUTTON_DEBOUNCE_MS pass without another. The
+ *                           button costs nothing while it is still.
+ * INPUT_DEBOUNCE_VERTICAL - The 1ms tick samples every PORTA input at once
+ *                           into a vertical counter (debounce.c), which
+ *                           reports each input's press and release edges.
+ *                           The cost is the same however many inputs a board
+ *                           has, but the part stays awake while any of them
+ *                           is changing, as the tick stops in SLEEP.
+ */
+#define INPUT_DEBOUNCE_IOC        0
+#define INPUT_DEBOUNCE_VERTICAL   1
+
+#ifndef INPUT_DEBOUNCE
+#define INPUT_DEBOUNCE        INPUT_DEBOUNCE_IOC
+#endif
+
+#endif // APP_CONFIG_H
@@ -0,0 +1,55 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Values shared between mainline and the ISR. See atomic.h.
+ */
+
+#include "mcc_generated_files/mcc.h"
+#include "atomic.h"
+
+#ifdef ISR_PROFILE
+// Timer1 when the outermost AtomicBegin turned interrupts off
+static uint16_t AtomicStart;
+#endif
+
+bool AtomicBegin(void)
+{
+  bool InterruptsOn = INTCONbits.GIE;
+
+  INTCONbits.GIE = 0;
+#ifdef ISR_PROFILE
+  if (InterruptsOn)
+  {
+    AtomicStart = INTERRUPT_ProfileTimer();
+  }
+#endif
+  return InterruptsOn;
+}
+
+void AtomicEnd(bool InterruptsOn)
+{
+  if (InterruptsOn)
+  {
+#ifdef ISR_PROFILE
+    INTERRUPT_ProfileMask(AtomicStart);
+#endif
+    INTCONbits.GIE = 1;
+  }
+}
+
+/* An interrupt that lands in one read leaves the other whole, so if they agree
+ * that is what they both read. It would take two writes to fake, and the ISR
+ * makes at most one in the time the two reads take.
+ */
+uint32_t ReadShared32(const volatile uint32_t *Value)
+{
+  uint32_t First;
+  uint32_t Second = *Value;
+
+  do
+  {
+    First = Second;
+    Second = *Value;
+  } while (First != Second);
+  return Second;
+}
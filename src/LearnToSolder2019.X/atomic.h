@@ -0,0 +1,45 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Values shared between mainline and the ISR
+ *
+ * The PIC reads and writes memory a byte at a time, so mainline can see a
+ * value of more than one byte that the ISR changes half way through being
+ * read, or lose an ISR change in the middle of its own read-modify-write. A
+ * single byte, or a bool, is always safe. For anything longer, mainline uses
+ * the cheapest of:
+ *
+ * - ReadShared32(), for a value the ISR changes at most once a millisecond,
+ *   such as WakeTimer. It reads it until two reads in a row agree, which one
+ *   interrupt can't fake, with interrupts on.
+ * - AtomicBegin() and AtomicEnd() around anything else: writes, read-modify-
+ *   writes, and reads of values that must agree with each other. Interrupts
+ *   are off in between, so keep it short.
+ *
+ * A sequence counter would let mainline read without masking as well, but
+ * costs the ISR an increment on every write, where the double read only costs
+ * mainline.
+ *
+ * Builds with ISR_PROFILE time every AtomicBegin() that turned
+ * interrupts off, up to its AtomicEnd(), and keep the longest in
+ * INTERRUPT_Profile.MaskWorstCycles.
+ */
+
+#ifndef ATOMIC_H
+#define ATOMIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Turn interrupts off. Returns whether they were on, for AtomicEnd. Can be
+// called with them already off, from mainline or the ISR.
+bool AtomicBegin(void);
+
+// Turn interrupts back on if they were on at the matching AtomicBegin
+void AtomicEnd(bool InterruptsOn);
+
+// Read a value the ISR changes at most once a millisecond. Mainline must
+// only change it between AtomicBegin and AtomicEnd.
+uint32_t ReadShared32(const volatile uint32_t *Value);
+
+#endif // ATOMIC_H
@@ -0,0 +1,102 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Input debouncing. See debounce.h.
+ */
+
+#include "mcc_generated_files/mcc.h"
+#include "debounce.h"
+#include "events.h"
+
+// PORTA pins that can be inputs
+#define DEBOUNCE_PINS         0x3F
+
+// Milliseconds until the next sample
+static uint8_t DebounceCountdown = DEBOUNCE_SAMPLE_MS;
+
+// The debounced state of each input
+static volatile uint8_t DebouncedDown;
+
+// Two bit count of the samples since each input last read as DebouncedDown,
+// bit 0 in DebounceCount0 and bit 1 in DebounceCount1. Both are set while an
+// input is steady, and they count down from there.
+static uint8_t DebounceCount0 = 0xFF;
+static uint8_t DebounceCount1 = 0xFF;
+
+// Edges not yet taken by mainline
+static volatile uint8_t InputPresses;
+static volatile uint8_t InputReleases;
+
+// Set from an edge on an input until a sample finds every input steady, and
+// at start up to take their first state
+static volatile bool DebounceBusy = true;
+
+// The inputs that are down right now, before debouncing
+static uint8_t ReadInputs(void)
+{
+  return (uint8_t)(~PORTA & TRISA & DEBOUNCE_PINS);
+}
+
+void DebounceInputs(void)
+{
+  uint8_t Changed;
+  uint8_t Flip;
+
+  if (--DebounceCountdown)
+  {
+    return;
+  }
+  DebounceCountdown = DEBOUNCE_SAMPLE_MS;
+
+  // Count down the inputs that differ from their debounced state, and reset
+  // the others, then flip the ones whose count has run out
+  Changed = ReadInputs() ^ DebouncedDown;
+  DebounceCount0 = (uint8_t)~(DebounceCount0 & Changed);
+  DebounceCount1 = DebounceCount0 ^ (DebounceCount1 & Changed);
+  Flip = Changed & DebounceCount0 & DebounceCount1;
+
+  DebouncedDown ^= Flip;
+  InputPresses |= Flip & DebouncedDown;
+  InputReleases |= Flip & (uint8_t)~DebouncedDown;
+  if (Flip)
+  {
+    PostEvent(EVENT_INPUTS_CHANGED, Flip);
+  }
+
+  // Any that changed without flipping are still being counted
+  DebounceBusy = (Changed ^ Flip) != 0;
+}
+
+bool InputChanged(void)
+{
+  bool Busy = DebounceBusy;
+
+  DebounceBusy = true;
+  return Busy;
+}
+
+uint8_t InputsDown(void)
+{
+  return DebouncedDown;
+}
+
+uint8_t TakeInputPresses(void)
+{
+  uint8_t Presses = InputPresses;
+
+  InputPresses = 0;
+  return Presses;
+}
+
+uint8_t TakeInputReleases(void)
+{
+  uint8_t Releases = InputReleases;
+
+  InputReleases = 0;
+  return Releases;
+}
+
+bool InputsSettling(void)
+{
+  return DebounceBusy;
+}
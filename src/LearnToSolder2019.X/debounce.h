@@ -0,0 +1,51 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Input debouncing
+ *
+ * A vertical counter debouncer for every PORTA input. Each input is one bit of
+ * a byte, and its two bit counter is the same bit of two more bytes, so all of
+ * the inputs are counted at once with a few byte wide operations. An input
+ * takes its new state after reading it on DEBOUNCE_SAMPLES samples in a row,
+ * and any sample that reads the old state again starts its count over. The
+ * time and RAM this takes are the same however many inputs there are.
+ *
+ * Inputs are active low, as the button is with its pull-up. Every result is a
+ * mask of PORTA bits, set for each input that is down. A sample that flips
+ * any input posts an EVENT_INPUTS_CHANGED (events.h) with the ones it flipped.
+ */
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Samples in a row an input must read its new state on
+#define DEBOUNCE_SAMPLES      4
+
+// Milliseconds between samples, so a change takes 15 to 20ms to be seen
+#define DEBOUNCE_SAMPLE_MS    5
+
+// Count one millisecond, sampling the inputs every DEBOUNCE_SAMPLE_MS. ISR
+// only.
+void DebounceInputs(void);
+
+// The debounced inputs that are down
+uint8_t InputsDown(void);
+
+// The inputs that have gone down, or up, since the last call. Interrupts
+// must be off.
+uint8_t TakeInputPresses(void);
+uint8_t TakeInputReleases(void);
+
+// Note an edge on an input, from its IOC interrupt. ISR only. Returns what
+// InputsSettling() was before, as the ISR can't call that too.
+bool InputChanged(void);
+
+// True from an edge InputChanged was told of until a sample finds every input
+// steady, so DebounceInputs must keep running for the change to be seen. Also
+// true until the first sample.
+bool InputsSettling(void);
+
+#endif // DEBOUNCE_H
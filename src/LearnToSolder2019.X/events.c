@@ -0,0 +1,67 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Events from the ISR to mainline. See events.h.
+ */
+
+#include "mcc_generated_files/mcc.h"
+#include "events.h"
+
+#define EVENT_QUEUE_MASK      (EVENT_QUEUE_SIZE - 1)
+
+static volatile Event_t EventQueue[EVENT_QUEUE_SIZE];
+
+// Where the next event goes, written only by PostEvent
+static volatile uint8_t EventHead;
+
+// Where the oldest event is, written only by TakeEvent
+static volatile uint8_t EventTail;
+
+// Events lost to a full queue, counted by PostEvent, and how many of them
+// TakeEventsLost has seen
+static volatile uint8_t EventsDropped;
+static uint8_t EventsDroppedSeen;
+
+void PostEvent(EventType_t Type, uint8_t Data)
+{
+  uint8_t Head = EventHead;
+
+  if ((uint8_t)(Head - EventTail) == EVENT_QUEUE_SIZE)
+  {
+    EventsDropped++;
+    return;
+  }
+  EventQueue[Head & EVENT_QUEUE_MASK].Type = (uint8_t)Type;
+  EventQueue[Head & EVENT_QUEUE_MASK].Data = Data;
+  // Only now is the slot mainline's to read
+  EventHead = (uint8_t)(Head + 1);
+}
+
+bool TakeEvent(Event_t *Event)
+{
+  uint8_t Tail = EventTail;
+
+  if (Tail == EventHead)
+  {
+    return false;
+  }
+  Event->Type = EventQueue[Tail & EVENT_QUEUE_MASK].Type;
+  Event->Data = EventQueue[Tail & EVENT_QUEUE_MASK].Data;
+  // Only now is the slot the ISR's to write again
+  EventTail = (uint8_t)(Tail + 1);
+  return true;
+}
+
+bool EventsPending(void)
+{
+  return (EventTail != EventHead) || (EventsDroppedSeen != EventsDropped);
+}
+
+bool TakeEventsLost(void)
+{
+  uint8_t Dropped = EventsDropped;
+  bool Lost = (Dropped != EventsDroppedSeen);
+
+  EventsDroppedSeen = Dropped;
+  return Lost;
+}
@@ -0,0 +1,54 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Events from the ISR to mainline
+ *
+ * A ring buffer of EVENT_QUEUE_SIZE events. The ISR is the only one to post
+ * to it and mainline the only one to take from it, and each side writes only
+ * its own index, a single byte, after it has finished with the slot. Neither
+ * side ever sees a slot half written, so mainline can take events with
+ * interrupts on.
+ *
+ * The indices run freely through 0 to 255 and are masked down to a slot, so
+ * the queue is full when they are EVENT_QUEUE_SIZE apart.
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Events the queue holds. Must be a power of two.
+#define EVENT_QUEUE_SIZE      8
+
+typedef enum
+{
+  EVENT_TIMER_EXPIRED,        // Data is the Timer_t that expired
+  EVENT_BUTTON_EDGE,          // Data is 1 if the edge left the button down
+  EVENT_INPUTS_CHANGED,       // Data is the inputs debounce.c flipped
+  EVENT_FRAME_DONE            // the ISR took the committed LED frame
+} EventType_t;
+
+typedef struct
+{
+  uint8_t Type;
+  uint8_t Data;
+} Event_t;
+
+// Add an event to the queue, or count it as lost if the queue is full. ISR
+// only: XC8 would keep a second copy for mainline to call.
+void PostEvent(EventType_t Type, uint8_t Data);
+
+// Take the oldest event into *Event. False if there is none.
+bool TakeEvent(Event_t *Event);
+
+// True if there are events to take, or events lost since TakeEventsLost was
+// last called
+bool EventsPending(void);
+
+// True if any event was lost to a full queue since the last call, so mainline
+// should look at everything an event could have told it of
+bool TakeEventsLost(void);
+
+#endif // EVENTS_H
@@ -12,6 +12,17 @@
  */
 
 #include "mcc_generated_files/mcc.h"
+#include "app_config.h"
+#include "swtimer.h"
+#include "debounce.h"
+#include "events.h"
+#include "atomic.h"
+#include "pattern.h"
+#include "pattern_shows.h"
+
+#if PATTERN_SHOW >= PATTERN_SHOW_COUNT
+#error PATTERN_SHOW must be one of the shows in pattern_shows.txt
+#endif
 
 // Button debounce time in milliseconds
 #define BUTTON_DEBOUNCE_MS   20
@@ -34,6 +45,9 @@
 // I/O pin that push button is on
 #define BUTTON_IO             PORTAbits.RA3
 
+// Its bit in the masks debounce.c reports
+#define INPUT_BUTTON          0x08
+
 #define TRISA_LEDS_ALL_OUTUPT 0xC8    // 0b11001000
 #define PORTA_LEDS_ALL_LOW    0x00
 
@@ -54,6 +68,32 @@
 #define LED_D3                0x04  // A2
 #define LED_D4                0x10  // A4
 #define LED_D5                0x20  // A5
+#define LED_ALL               (LED_D1 | LED_D2 | LED_D3 | LED_D4 | LED_D5)
+
+#if LED_HW_PWM
+// D1-D3 are on the hardware PWM modules, so RunTMR0 only drives D4 and D5
+#define LED_FIRST_SOFTWARE    3
+#define LED_SOFTWARE          (LED_D4 | LED_D5)
+#else
+#define LED_FIRST_SOFTWARE    0
+#define LED_SOFTWARE          LED_ALL
+#endif
+#define LED_SOFTWARE_COUNT    (5 - LED_FIRST_SOFTWARE)
+
+#if IDLE_SLEEP
+// The PWM modules count LFINTOSC through a 256 count period, one per step of
+// brightness (see pwm1.c)
+#define PWM_HW_SHIFT          0
+#else
+// The PWM modules count Fosc through a 65536 count period, 256 per step
+#define PWM_HW_SHIFT          8
+#endif
+
+// WDTPS of the longest watchdog period SleepFor uses, 1:32768 (1s). Each step
+// down halves it, to 1:32 (1ms) at 0. The watchdog goes to 1:8388608 (256s),
+// but a sleep the button cuts short is only counted at a guess, so shorter
+// periods keep the guess close.
+#define WDT_PERIOD_MAX        10
 
 // Maximum number of milliseconds to allow system to run
 #define MAX_AWAKE_TIME_MS     (5UL * 60UL * 1000UL)
@@ -67,122 +107,718 @@ typedef enum {
     BUTTON_STATE_RELEASED
 } ButtonState_t;
 
+/* LED interface from mainline to ISR: a 0 to 255 brightness value for each LED,
+ * double buffered. The ISR shows the front frame. Mainline draws the next one
+ * into LEDBrightness between BeginLEDFrame() and CommitLEDFrame(), and the ISR
+ * swaps the two at the start of its next PWM frame, so a frame is never shown
+ * half drawn.
+ */
+static volatile uint8_t LEDFrames[2][5];
+static volatile uint8_t * volatile LEDBrightness = LEDFrames[1];
+static volatile bool LEDFrameCommitted;
+// Post EVENT_FRAME_DONE when the ISR takes the committed frame
+static volatile bool LEDFrameDoneWanted;
+
+// Used only in ISR: the frame being shown
+static volatile uint8_t *LEDFront = LEDFrames[0];
+
+#if LED_FRAME_HANDLER
+// Called from the ISR when it starts showing a committed frame
+static void (*LEDFrameHandler)(void);
+#endif
+
+// Number of instruction cycles in one millisecond
+#define CYCLES_PER_MS         (_XTAL_FREQ / 4000UL)
+
+#if CLOCK_GOVERNOR
+// OSCCON and Timer2 prescale for the full clock, as SYSTEM_Initialize sets
+// them, and for the idle clock. PR2 stays at 249 for a 1ms period at both.
+#define OSCCON_FULL           0x78  // IRCF 16MHz_HF
+#define T2CKPS_FULL           2     // 1:16
+#define OSCCON_IDLE           0x68  // IRCF 4MHz_HF
+#define T2CKPS_IDLE           1     // 1:4
+
+// The idle clock is this many times slower, as a shift
+#define CLOCK_IDLE_SHIFT      2
+
+// How many times slower than _XTAL_FREQ the clock is running, as a shift
+static uint8_t ClockShift;
+#endif
+
+#if PWM_ENGINE == PWM_ENGINE_EDGE
+// Number of PWM steps in one frame
+#define PWM_STEPS_PER_FRAME   256
+
+// Most edges a frame can have: the start of the frame, plus one edge for each
+// LED turning off, and one for each turning on as well when staggered
+#if LED_STAGGER
+#define PWM_EDGES_MAX         (2 * LED_SOFTWARE_COUNT + 1)
+#else
+#define PWM_EDGES_MAX         (LED_SOFTWARE_COUNT + 1)
+#endif
+
+// Used only in ISR: the LATA value for each edge of the current frame, and the
+// number of steps from that edge to the next one (0 means a full 256 steps).
+// Edge 0 is the start of the frame.
+static uint8_t PWMEdgeLATA[PWM_EDGES_MAX];
+static uint8_t PWMEdgeSpan[PWM_EDGES_MAX];
+static uint8_t PWMEdgeCount = 1;
+
+// Used only in ISR: the next edge to output
+static uint8_t PWMEdge;
+
+#elif PWM_ENGINE == PWM_ENGINE_BAM
+// Bits 0-2 share the first slot of a frame, then bits 3-7 get one each
+#define BAM_SLOTS             6
+
+// Instruction cycles for the LATA write between the inline bit 0-2 slots
+#define BAM_WRITE_CYCLES      4
+
+// Length of each slot in BAM units (TMR0 counts)
+static const uint8_t BAMSlotUnits[BAM_SLOTS] = {7, 8, 16, 32, 64, 128};
+
+// Used only in ISR: the LATA value for each bit of the brightness
+static uint8_t BAMBitLATA[8];
+
+// Used only in ISR: the next slot to output
+static uint8_t BAMSlot;
+
+#elif PWM_ENGINE == PWM_ENGINE_DITHER
+#if (DITHER_STEPS < 2) || (DITHER_STEPS > 128)
+#error DITHER_STEPS must be 2 to 128
+#endif
+
+// Start or stop step of an LED that is lit for the whole frame
+#define DITHER_NEVER          0xFF
+
+// Used only in ISR: the part of each LED's brightness still to be shown, in
+// 1/256ths of a step
+static uint8_t DitherError[5];
+
+// Used only in ISR: the steps where each LED turns on and off this frame, and
+// the step that is next
+static uint8_t DitherStart[5];
+static uint8_t DitherStop[5];
+static uint8_t DitherStep;
 
 // Working copy of LED bits to copy directly to LATA in the ISR
 static uint8_t LATALEDs;
+#else
+// Used only in ISR: the step of the PWM frame that is next
+static uint8_t PWMCounter;
 
-// LED interface from mainline to ISR: a 0 to 255 brightness value for each LED
-static volatile uint8_t LEDBrightness[5];
-
-// Used only in ISR to track where in PWM cycle each LED is
-static uint8_t LEDPWMCount[5];
+// Working copy of LED bits to copy directly to LATA in the ISR
+static uint8_t LATALEDs;
+#endif
 
 // Counts number of milliseconds we are awake for, and puts us to sleep if 
 // we stay awake for too long
 volatile static uint32_t WakeTimer;
 
-// Counts down from SHUTDOWN_DELAY_MS after everything is over before we go to sleep
-volatile static uint8_t ShutdownDelayTimer;
-
-// Countdown 1ms timers to  debounce the button inputs
-volatile static uint8_t DebounceTimer;
-
 // Keep track of the state of each button during debounce
 volatile static ButtonState_t ButtonState = BUTTON_STATE_IDLE;
 
 // Record the last value of WakeTimer when the button was pushed
 volatile static uint32_t LastButtonPressTime;
 
-volatile static uint16_t NextPatternStepTimer;
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+// Set by the IOC interrupt on each edge of the button: the WakeTimer
+// millisecond it came in, and whether it left the button pressed
+static volatile uint32_t ButtonEdgeTime;
+static volatile bool ButtonEdgePressed;
+
+// True from the first edge of a change until BUTTON_DEBOUNCE_MS have passed
+// without another one and CheckForButtonPushes takes the new state
+static volatile bool ButtonSettling;
+#endif
+
+// True while a show is playing, and where it is up to in PatternCode
+static bool PatternRunning;
+static uint16_t PatternPC;
 
-static uint8_t PatternState;
+#if PATTERN_SHOW_CYCLE
+// The show the next press plays
+static uint8_t PatternShow = PATTERN_SHOW;
+#endif
+
+// The playing show's PATTERN_LOOPs, innermost last: where each one's body
+// starts, and how many more times it runs, or 0 for ever
+static uint16_t PatternLoopStart[PATTERN_LOOP_DEPTH];
+static uint8_t PatternLoopCount[PATTERN_LOOP_DEPTH];
+static uint8_t PatternLoopDepth;
+
+// Where the playing show's PATTERN_PALETTE levels are in PatternCode
+static uint16_t PatternPalette;
+
+// Where the next step time of the playing show's tempo curve is in
+// PatternCode, how many are left, and whether they're 16 bit
+static uint16_t PatternTempo;
+static uint8_t PatternTempoLeft;
+static bool PatternTempoWide;
+
+// The playing show's PatternFade_t, and whether a frame is waiting to be faded
+// to over the next wait
+static uint8_t PatternFade;
+static bool PatternFadePending;
+
+// What each LED shows now, and the frame it is fading to
+static uint8_t PatternLevel[5];
+static uint8_t PatternTarget[5];
+
+/* The fade under way: PatternFadeLeft of PatternFadeMs milliseconds to go.
+ * PATTERN_FADE_LINEAR moves each LED PatternFadeDiff levels in all, a level
+ * each time the LED's PatternFadeAcc has gathered PatternFadeMs, the way a
+ * DDA draws a line. PATTERN_FADE_EASE keeps each LED's level in PatternFadeAcc
+ * as 8.8 fixed point, and closes 1/2^PatternFadeShift of its gap each ms.
+ */
+static uint16_t PatternFadeMs;
+static uint16_t PatternFadeLeft;
+static uint8_t PatternFadeShift;
+static uint8_t PatternFadeDiff[5];
+static uint16_t PatternFadeAcc[5];
+
+// The generator instruction in PatternCode that is making the frames, if
+// PatternGenerating. PATTERN_WAVE and PATTERN_SCAN step a phase through the
+// sine wave each ms, one for each LED or one for the scan.
+static bool PatternGenerating;
+static uint16_t PatternGenerator;
+static uint16_t PatternPhase[5];
+
+// 16 bit Galois LFSR for PATTERN_FLICKER and PATTERN_SPARKLE. Never 0.
+static uint16_t PatternRandom = 0xACE1;
+
+// The first quarter of a sine wave, 64 steps from 0 to 90 degrees, as 0 to 127
+static const uint8_t PatternQuarterSine[64] = {
+    2,   5,   8,  11,  14,  17,  20,  23,  26,  29,  32,  35,  38,  41,  44,  47,
+   50,  53,  56,  58,  61,  64,  67,  69,  72,  74,  77,  79,  82,  84,  86,  89,
+   91,  93,  95,  97,  99, 101, 103, 105, 106, 108, 110, 111, 113, 114, 115, 117,
+  118, 119, 120, 121, 122, 123, 124, 124, 125, 125, 126, 126, 127, 127, 127, 127,
+};
 
 static uint16_t PatternSpeed = 0;
 
+/* Start drawing a new frame into LEDBrightness. A frame that was committed but
+ * not yet picked up by the ISR is withdrawn, and this one replaces it. Every
+ * LED must be written before the frame is committed, as LEDBrightness may hold
+ * an older frame.
+ */
+void BeginLEDFrame(void)
+{
+  LEDFrameCommitted = false;
+}
+
+// Hand the frame in LEDBrightness to the ISR, to show from its next PWM frame.
+// With WantDone, the ISR posts EVENT_FRAME_DONE when it takes it, for a caller
+// that has the next frame to draw.
+void CommitLEDFrame(bool WantDone)
+{
+  LEDFrameDoneWanted = WantDone;
+  LEDFrameCommitted = true;
+}
+
+#if LED_FRAME_HANDLER
+// Set the function the ISR calls when it starts showing a committed frame.
+// It runs in the interrupt, so it should only note that LEDBrightness is free.
+void SetLEDFrameHandler(void (* Handler)(void))
+{
+  LEDFrameHandler = Handler;
+}
+#endif
+
+/* Pick up the frame mainline last committed, if there is one. The old front
+ * frame becomes the one mainline draws into next. Called from the ISR at the
+ * start of each PWM frame, before anything reads LEDFront.
+ */
+static void TakeLEDFrame(void)
+{
+  volatile uint8_t *Frame;
+
+  if (LEDFrameCommitted)
+  {
+    Frame = LEDFront;
+    LEDFront = LEDBrightness;
+    LEDBrightness = Frame;
+    LEDFrameCommitted = false;
+    if (LEDFrameDoneWanted)
+    {
+      PostEvent(EVENT_FRAME_DONE, 0);
+    }
+#if LED_FRAME_HANDLER
+    if (LEDFrameHandler)
+    {
+      LEDFrameHandler();
+    }
+#endif
+  }
+}
+
 void SetAllLEDsOff(void)
 {
   uint8_t i;
   
+  BeginLEDFrame();
   for (i=0; i < 5; i++)
   {
       LEDBrightness[i] = 0;
   }
+  CommitLEDFrame(false);
+}
+
+// Count one millisecond for WakeTimer and the software timers. Called from
+// TMR2_ISR.
+void RunOneMSTasks(void)
+{
+  // Always increment wake timer to count this millisecond
+  WakeTimer++;
+
+  RunTimers();
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_VERTICAL
+  DebounceInputs();
+#endif
+}
+
+#if LED_HW_PWM
+/* Hand D1-D3's brightness to the hardware PWM modules. A brightness of N gives
+ * the same N/256 duty as the software PWM. The modules pick the new values up
+ * at the end of their current period. Called from the ISR.
+ */
+static void LoadHardwarePWM(void)
+{
+#if LED_STAGGER
+  uint16_t Phase[3];
+  uint8_t Level;
+  uint8_t Start = 0;
+  uint8_t i;
+
+  // Run D1-D3 one after another through the period. A module can't carry a
+  // pulse over the end of its period, so an LED that would run past it is
+  // moved back to finish there instead.
+  for (i=0; i < 3; i++)
+  {
+    Level = LEDFront[i];
+    if ((uint16_t)Start + Level > 255)
+    {
+      Start = 255 - Level;
+    }
+    Phase[i] = (uint16_t)Start << PWM_HW_SHIFT;
+    Start += Level;
+  }
+  PWM2_PhaseSet(Phase[0]);                                           // D1
+  PWM2_DutyCycleSet(Phase[0] + ((uint16_t)LEDFront[0] << PWM_HW_SHIFT));
+  PWM1_PhaseSet(Phase[1]);                                           // D2
+  PWM1_DutyCycleSet(Phase[1] + ((uint16_t)LEDFront[1] << PWM_HW_SHIFT));
+  PWM3_PhaseSet(Phase[2]);                                           // D3
+  PWM3_DutyCycleSet(Phase[2] + ((uint16_t)LEDFront[2] << PWM_HW_SHIFT));
+#else
+  PWM2_DutyCycleSet((uint16_t)LEDFront[0] << PWM_HW_SHIFT);   // D1
+  PWM1_DutyCycleSet((uint16_t)LEDFront[1] << PWM_HW_SHIFT);   // D2
+  PWM3_DutyCycleSet((uint16_t)LEDFront[2] << PWM_HW_SHIFT);   // D3
+#endif
+  PWM2_LoadBufferSet();
+  PWM1_LoadBufferSet();
+  PWM3_LoadBufferSet();
+}
+#endif
+
+#if PWM_ENGINE == PWM_ENGINE_EDGE
+#if LED_STAGGER
+// Add Step to the Count ascending steps in Steps[] unless it is already there.
+// Returns the new count.
+static uint8_t InsertPWMStep(uint8_t *Steps, uint8_t Count, uint8_t Step)
+{
+  uint8_t j;
+
+  for (j=0; j < Count; j++)
+  {
+    if (Steps[j] == Step)
+    {
+      return Count;
+    }
+  }
+  for (j=Count; (j > 0) && (Steps[j-1] > Step); j--)
+  {
+    Steps[j] = Steps[j-1];
+  }
+  Steps[j] = Step;
+  return Count + 1;
+}
+
+/* Work out the edges of the next PWM frame from the front LED frame. The LEDs
+ * take turns: each one turns on at the step where the one before it turned
+ * off, carrying on from the start of the frame if it runs past the end. The
+ * edges are the distinct steps where any LED turns on or off, in ascending
+ * order, and the LATA value for each is worked out from which LEDs cover that
+ * step.
+ */
+static void BuildPWMFrame(void)
+{
+  static const uint8_t LEDBits[5] = {LED_D1, LED_D2, LED_D3, LED_D4, LED_D5};
+  uint8_t Level[5];
+  uint8_t Start[5];
+  uint8_t Steps[PWM_EDGES_MAX];
+  uint8_t Count;
+  uint8_t i;
+  uint8_t Step;
+  uint8_t Edge;
+  uint8_t Bits;
+
+  TakeLEDFrame();
+#if LED_HW_PWM
+  LoadHardwarePWM();
+#endif
+
+  // Edge 0 is always the start of the frame
+  Steps[0] = 0;
+  Count = 1;
+  Step = 0;
+  for (i=0; i < LED_SOFTWARE_COUNT; i++)
+  {
+    Level[i] = LEDFront[LED_FIRST_SOFTWARE + i];
+    Start[i] = Step;
+    if (Level[i])
+    {
+      Count = InsertPWMStep(Steps, Count, Step);
+      Step += Level[i];
+      Count = InsertPWMStep(Steps, Count, Step);
+    }
+  }
+
+  for (Edge=0; Edge < Count; Edge++)
+  {
+    Step = Steps[Edge];
+    Bits = 0;
+    for (i=0; i < LED_SOFTWARE_COUNT; i++)
+    {
+      if ((uint8_t)(Step - Start[i]) < Level[i])
+      {
+        Bits |= LEDBits[LED_FIRST_SOFTWARE + i];
+      }
+    }
+    PWMEdgeLATA[Edge] = Bits;
+    // The last edge runs to the end of the frame (0 when that is a full 256
+    // steps)
+    PWMEdgeSpan[Edge] = (uint8_t)(((Edge + 1 < Count) ? Steps[Edge+1] : 0) - Step);
+  }
+  PWMEdgeCount = Count;
+}
+#else
+/* Work out the edges of the next PWM frame from the front LED frame. Each LED
+ * is on from the start of the frame until the step equal to its brightness, so
+ * the edges are the distinct non-zero brightness values in ascending order.
+ * LEDs that share a brightness share an edge.
+ */
+static void BuildPWMFrame(void)
+{
+  static const uint8_t LEDBits[5] = {LED_D1, LED_D2, LED_D3, LED_D4, LED_D5};
+  uint8_t Level[5];
+  uint8_t Bits[5];
+  uint8_t i;
+  uint8_t j;
+  uint8_t Step;
+  uint8_t Edge;
+
+  TakeLEDFrame();
+#if LED_HW_PWM
+  LoadHardwarePWM();
+#endif
+
+  // Insertion sort the brightness values, carrying each LED's bit along
+  for (i=0; i < LED_SOFTWARE_COUNT; i++)
+  {
+    Step = LEDFront[LED_FIRST_SOFTWARE + i];
+    for (j=i; (j > 0) && (Level[j-1] > Step); j--)
+    {
+      Level[j] = Level[j-1];
+      Bits[j] = Bits[j-1];
+    }
+    Level[j] = Step;
+    Bits[j] = LEDBits[LED_FIRST_SOFTWARE + i];
+  }
+
+  // Edge 0 turns on every LED that is lit at all
+  PWMEdgeLATA[0] = LED_SOFTWARE;
+  Edge = 0;
+  Step = 0;
+  for (i=0; i < LED_SOFTWARE_COUNT; i++)
+  {
+    if (Level[i] != Step)
+    {
+      PWMEdgeSpan[Edge] = Level[i] - Step;
+      Edge++;
+      PWMEdgeLATA[Edge] = PWMEdgeLATA[Edge-1];
+      Step = Level[i];
+    }
+    PWMEdgeLATA[Edge] &= ~Bits[i];
+  }
+
+  // The last edge runs to the end of the frame (0 when the frame has only
+  // edge 0, which is a full 256 steps)
+  PWMEdgeSpan[Edge] = (uint8_t)(PWM_STEPS_PER_FRAME - Step);
+  PWMEdgeCount = Edge + 1;
+}
+#endif
+
+/* This ISR runs at each LED edge, at most 6 times per PWM frame.
+ * TMR0_ISR has already reloaded TMR0 for the period from this edge to the
+ * next, so this sets up the reload for the period after that.
+ */
+void RunTMR0(void)
+{
+
+  LATA = PWMEdgeLATA[PWMEdge];
+
+  // After the last edge of a frame, set up the next frame
+  PWMEdge++;
+  if (PWMEdge >= PWMEdgeCount)
+  {
+    BuildPWMFrame();
+    PWMEdge = 0;
+  }
+  TMR0_SetReload((uint8_t)(0 - PWMEdgeSpan[PWMEdge]));
+}
+#elif PWM_ENGINE == PWM_ENGINE_BAM
+// Split the front LED frame into the LEDs to light for each bit of the next frame
+static void BuildBAMFrame(void)
+{
+  static const uint8_t LEDBits[5] = {LED_D1, LED_D2, LED_D3, LED_D4, LED_D5};
+  uint8_t i;
+  uint8_t Bit;
+  uint8_t Level;
+
+  TakeLEDFrame();
+#if LED_HW_PWM
+  LoadHardwarePWM();
+#endif
+
+  for (Bit=0; Bit < 8; Bit++)
+  {
+    BAMBitLATA[Bit] = 0;
+  }
+  for (i=LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    Level = LEDFront[i];
+    for (Bit=0; Bit < 8; Bit++)
+    {
+      if (Level & 0x01)
+      {
+        BAMBitLATA[Bit] |= LEDBits[i];
+      }
+      Level >>= 1;
+    }
+  }
 }
 
-/* This ISR runs every 125 uS. 
- * It also handles a number of software timer decrementing every 1ms.
+/* This ISR runs at the start of each BAM slot, 6 times per frame.
+ * TMR0_ISR has already reloaded TMR0 for the slot that is starting, so this
+ * sets up the reload for the slot after it. Bits 0-2 are shorter than an
+ * interrupt takes, so the first slot of a frame times them with delays and
+ * leaves bit 2 showing until the bit 3 slot.
  */
 void RunTMR0(void)
 {
+  if (BAMSlot == 0)
+  {
+    LATA = BAMBitLATA[0];
+    _delay(BAM_UNIT_CYCLES - BAM_WRITE_CYCLES);
+    LATA = BAMBitLATA[1];
+    _delay(2 * BAM_UNIT_CYCLES - BAM_WRITE_CYCLES);
+    LATA = BAMBitLATA[2];
+  }
+  else
+  {
+    LATA = BAMBitLATA[BAMSlot + 2];
+  }
+
+  // After the last slot of a frame starts, set up the next frame
+  BAMSlot++;
+  if (BAMSlot >= BAM_SLOTS)
+  {
+    BuildBAMFrame();
+    BAMSlot = 0;
+  }
+  // TMR0_ISR reloads a unit after the overflow, so load one unit fewer
+  TMR0_SetReload((uint8_t)(1 - BAMSlotUnits[BAMSlot]));
+}
+#elif PWM_ENGINE == PWM_ENGINE_DITHER
+/* Work out when each LED turns on and off in the next frame. Each brightness
+ * is scaled to DITHER_STEPS steps, and whatever is left over is carried to
+ * the next frame, so an LED between two step levels alternates between them
+ * in the right proportion.
+ */
+static void BuildDitherFrame(void)
+{
+  static const uint8_t LEDBits[5] = {LED_D1, LED_D2, LED_D3, LED_D4, LED_D5};
+  uint16_t Sum;
+  uint8_t Level;
+#if LED_STAGGER
+  uint8_t Start = 0;
+#endif
+  uint8_t i;
+
+  TakeLEDFrame();
+#if LED_HW_PWM
+  LoadHardwarePWM();
+#endif
+
+  LATALEDs = 0;
+  for (i=LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    Sum = (uint16_t)LEDFront[i] * DITHER_STEPS + DitherError[i];
+    Level = (uint8_t)(Sum >> 8);
+    DitherError[i] = (uint8_t)Sum;
+
+    if (Level >= DITHER_STEPS)
+    {
+      LATALEDs |= LEDBits[i];
+      DitherStart[i] = DITHER_NEVER;
+      DitherStop[i] = DITHER_NEVER;
+    }
+    else
+    {
+#if LED_STAGGER
+      // Turn on where the last LED turned off. One that runs past the end of
+      // the frame starts it already lit.
+      DitherStart[i] = Start;
+      Start += Level;
+      if (Start >= DITHER_STEPS)
+      {
+        Start -= DITHER_STEPS;
+        LATALEDs |= LEDBits[i];
+      }
+      DitherStop[i] = Start;
+#else
+      DitherStart[i] = 0;
+      DitherStop[i] = Level;
+#endif
+    }
+  }
+}
+
+// This ISR runs DITHER_STEPS times per frame.
+void RunTMR0(void)
+{
+  static const uint8_t LEDBits[5] = {LED_D1, LED_D2, LED_D3, LED_D4, LED_D5};
+  uint8_t i;
+
+  if (DitherStep == 0)
+  {
+    BuildDitherFrame();
+  }
+
+  // An LED with a level of 0 turns on and off at the same step, so stays off
+  for (i=LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    if (DitherStart[i] == DitherStep)
+    {
+      LATALEDs |= LEDBits[i];
+    }
+    if (DitherStop[i] == DitherStep)
+    {
+      LATALEDs &= ~LEDBits[i];
+    }
+  }
+  LATA = LATALEDs;
+
+  DitherStep++;
+  if (DitherStep >= DITHER_STEPS)
+  {
+    DitherStep = 0;
+  }
+}
+#else
+// This ISR runs every 32 uS.
+void RunTMR0(void)
+{
+#if LED_STAGGER
   uint8_t i;
-  static uint8_t PWMCounter = 0;
-  static uint8_t OneMSCounter = 0;
-  static uint8_t LEDBrightnessShadow[5] = {0,0,0,0,0};
+  static const uint8_t LEDBits[5] = {LED_D1, LED_D2, LED_D3, LED_D4, LED_D5};
+  static uint8_t LEDStopShadow[5] = {0,0,0,0,0};
+  uint8_t Start;
+#endif
 
   if (PWMCounter == 0)
   {
-    LATALEDs = 0xFF;
-    for (i=0; i < 5; i++)
+    TakeLEDFrame();
+#if LED_STAGGER
+    // Each LED turns on at the step where the one before it turns off, so
+    // only the step each one stops at is needed. An LED that runs past the
+    // end of the frame starts the next one already lit.
+    LATALEDs = LEDBits[LED_FIRST_SOFTWARE];
+    Start = 0;
+    for (i=LED_FIRST_SOFTWARE; i < 5; i++)
     {
-      LEDBrightnessShadow[i] = LEDBrightness[i];
+      LEDStopShadow[i] = Start + LEDFront[i];
+      if (LEDStopShadow[i] < Start)
+      {
+        LATALEDs |= LEDBits[i];
+      }
+      Start = LEDStopShadow[i];
     }
+#else
+    LATALEDs = 0xFF;
+#endif
+#if LED_HW_PWM
+    // The PWM modules override LATA on D1-D3, so their bits here don't matter
+    LoadHardwarePWM();
+#endif
   }
   
-  // If an LED's brightness matches the counter, then turn the LED off
-  if (LEDBrightnessShadow[0] == PWMCounter)
+#if LED_STAGGER
+  // When an LED's stop step matches the counter, hand over to the next LED.
+  // An LED with a brightness of 0 stops where it starts, so it never lights.
+#if !LED_HW_PWM
+  if (LEDStopShadow[0] == PWMCounter)
+  {
+    LATALEDs = (LATALEDs & ~LED_D1) | LED_D2;
+  }
+  if (LEDStopShadow[1] == PWMCounter)
+  {
+    LATALEDs = (LATALEDs & ~LED_D2) | LED_D3;
+  }
+  if (LEDStopShadow[2] == PWMCounter)
+  {
+    LATALEDs = (LATALEDs & ~LED_D3) | LED_D4;
+  }
+#endif
+  if (LEDStopShadow[3] == PWMCounter)
+  {
+    LATALEDs = (LATALEDs & ~LED_D4) | LED_D5;
+  }
+  if (LEDStopShadow[4] == PWMCounter)
+  {
+    LATALEDs &= ~LED_D5;
+  }
+#else
+  // If an LED's brightness matches the counter, then turn the LED off. The
+  // front frame only changes at the start of a frame, so it is read directly.
+  if (LEDFront[0] == PWMCounter)
   {
     LATALEDs &= ~LED_D1;
   }
-  if (LEDBrightnessShadow[1] == PWMCounter)
+  if (LEDFront[1] == PWMCounter)
   {
     LATALEDs &= ~LED_D2;
   }
-  if (LEDBrightnessShadow[2] == PWMCounter)
+  if (LEDFront[2] == PWMCounter)
   {
     LATALEDs &= ~LED_D3;
   }
-  if (LEDBrightnessShadow[3] == PWMCounter)
+  if (LEDFront[3] == PWMCounter)
   {
     LATALEDs &= ~LED_D4;
   }
-  if (LEDBrightnessShadow[4] == PWMCounter)
+  if (LEDFront[4] == PWMCounter)
   {
     LATALEDs &= ~LED_D5;
   }
+#endif
 
   // As a final step, copy over the bits we've set up for the 5 LEDs
   LATA = LATALEDs;
   
   PWMCounter++;
-  
-  // Check to see if it's time to run the 1ms code
-  OneMSCounter++;
-  if (OneMSCounter >= TMR0_TICKS_PER_MS)
-  {
-    // Approximately 1ms has passed since last time OneMSCounter was 0, so
-    // perform the 1ms tasks
-    OneMSCounter = 0;
-
-    // Always increment wake timer to count this millisecond
-    WakeTimer++;
-
-    // Decrement button debounce timers
-    if (DebounceTimer)
-    {
-        DebounceTimer--;
-    }
-
-    if (ShutdownDelayTimer)
-    {
-      ShutdownDelayTimer--;
-    }
-    
-    if (NextPatternStepTimer)
-    {
-      NextPatternStepTimer--;
-    }
-  }
 }
+#endif
 
 // Return the raw state of the button input
 bool ButtonPressedRaw(void)
@@ -190,174 +826,757 @@ bool ButtonPressedRaw(void)
   return (uint8_t)(BUTTON_IO == 0);
 }
 
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+/* Stamp an edge on the button with the time and the level it left. Bounces
+ * only move the stamp. The first edge of a change posts an EVENT_BUTTON_EDGE,
+ * and CheckForButtonPushes times the rest with TIMER_DEBOUNCE. Called from the
+ * IOC interrupt only, and so reads the pin itself rather than through
+ * ButtonPressedRaw, as XC8 makes a second copy of any function called from
+ * both the interrupt and mainline.
+ */
+void ButtonChanged(void)
+{
+  ButtonEdgeTime = WakeTimer;
+  ButtonEdgePressed = (BUTTON_IO == 0);
+  if (!ButtonSettling)
+  {
+    ButtonSettling = true;
+    PostEvent(EVENT_BUTTON_EDGE, ButtonEdgePressed);
+  }
+}
+#else
+/* Keep the main loop awake for DebounceInputs while the button changes. The
+ * first edge of a change posts an EVENT_BUTTON_EDGE, and DebounceInputs posts
+ * the new state once it has settled. Called from the IOC interrupt.
+ */
+void ButtonChanged(void)
+{
+  if (!InputChanged())
+  {
+    PostEvent(EVENT_BUTTON_EDGE, BUTTON_IO == 0);
+  }
+}
+#endif
+
 // Return the logical (debounced) state of the button
 bool ButtonPressed(void)
 {
     return (ButtonState == BUTTON_STATE_PRESSED);
 }
 
-// Return true if button is currently down
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+/* Bring ButtonState up to date with the edges ButtonChanged has stamped. The
+ * button has settled once its last edge is BUTTON_DEBOUNCE_MS old. Until then
+ * TIMER_DEBOUNCE is kept running for the rest of the time from that edge, so
+ * this is called again when it runs out. Return true if button is currently
+ * down.
+ */
 bool CheckForButtonPushes(void)
 {  
-  // Debounce button press
-  if (ButtonPressedRaw())
+  uint32_t Quiet;
+  bool InterruptsOn;
+
+  InterruptsOn = AtomicBegin();
+  if (ButtonSettling)
   {
-    if (ButtonState == BUTTON_STATE_PRESSED_TIMING)
+    Quiet = WakeTimer - ButtonEdgeTime;
+    if (Quiet < BUTTON_DEBOUNCE_MS)
     {
-      if (DebounceTimer == 0)
+      ButtonState = ButtonEdgePressed ? BUTTON_STATE_PRESSED_TIMING : BUTTON_STATE_RELEASED_TIMING;
+      if (TimerExpired(TIMER_DEBOUNCE))
       {
-        ButtonState = BUTTON_STATE_PRESSED;
+        StartTimer(TIMER_DEBOUNCE, (uint16_t)(BUTTON_DEBOUNCE_MS - Quiet));
       }
     }
-    else if (ButtonState != BUTTON_STATE_PRESSED)
+    else
     {
-      ButtonState = BUTTON_STATE_PRESSED_TIMING;
-      DebounceTimer = BUTTON_DEBOUNCE_MS;
+      ButtonState = ButtonEdgePressed ? BUTTON_STATE_PRESSED : BUTTON_STATE_RELEASED;
+      ButtonSettling = false;
     }
   }
+  AtomicEnd(InterruptsOn);
+    
+  return ((bool)(ButtonPressedRaw()));
+}
+#else
+/* Bring ButtonState up to date with what debounce.c has seen of the button. A
+ * press counts even if the button is up again by now, so one between two
+ * calls isn't missed. Return true if button is currently down.
+ */
+bool CheckForButtonPushes(void)
+{
+  uint8_t Presses;
+  bool Down;
+  bool InterruptsOn;
+
+  InterruptsOn = AtomicBegin();
+  Presses = TakeInputPresses();
+  (void)TakeInputReleases();
+  Down = (InputsDown() & INPUT_BUTTON) != 0;
+  AtomicEnd(InterruptsOn);
+
+  if (Presses & INPUT_BUTTON)
+  {
+    ButtonState = BUTTON_STATE_PRESSED;
+  }
+  else if (ButtonPressedRaw() != Down)
+  {
+    ButtonState = Down ? BUTTON_STATE_RELEASED_TIMING : BUTTON_STATE_PRESSED_TIMING;
+  }
   else
   {
-    if (ButtonState == BUTTON_STATE_RELEASED_TIMING)
-    {
-      if (DebounceTimer == 0)
-      {
-        ButtonState = BUTTON_STATE_RELEASED;
-      }
-    }
-    else if (ButtonState != BUTTON_STATE_RELEASED)
-    {
-      ButtonState = BUTTON_STATE_RELEASED_TIMING;
-      DebounceTimer = BUTTON_DEBOUNCE_MS;
-    }
+    ButtonState = Down ? BUTTON_STATE_PRESSED : BUTTON_STATE_RELEASED;
   }
-    
+
   return ((bool)(ButtonPressedRaw()));
 }
+#endif
 
 uint32_t PatternStartTime;
 
-// Trigger the start of an LED pattern
-void StartPattern(void)
-{
-  NextPatternStepTimer = 1;
-  PatternState = 1;
-  PatternSpeed = 150;
-  LEDBrightness[0] = 0;
-  LEDBrightness[1] = 0;
-  LEDBrightness[2] = 0;
-  LEDBrightness[3] = 0;
-  LEDBrightness[4] = 0;
-}
-
-uint8_t Pattern[8][5] = {
-  {50, 0, 0, 0, 1},
-  { 0,50, 0, 1, 0},
-  { 0, 0,50, 0, 0},
-  { 0, 1, 0,50, 0},
-  { 1, 0, 0, 0,50},
-  { 0, 1, 0,50, 0},
-  { 0, 0,50, 0, 0},
-  { 0,50, 0, 1, 0}
-};
-
-// If an LED pattern is running, do whatever needs to be done to run it
-// Return true if pattern is still playing back, false if it's done
-bool RunPattern(void)
+// Show PatternLevel on the LEDs
+static void CommitPatternLevels(void)
 {
-  bool ReturnValue = true;
   uint8_t i;
-  static uint8_t BlinkCount = 0;
-  
-  switch (PatternState)
-  {
-    case 0:
-      // Do nothing, as state zero is "no pattern playing"
-      LEDBrightness[0] = 0;
-      LEDBrightness[1] = 0;
-      LEDBrightness[2] = 0;
-      LEDBrightness[3] = 0;
-      LEDBrightness[4] = 0;
-      ReturnValue = false;
+
+  BeginLEDFrame();
+  for (i=0; i < 5; i++)
+  {
+    LEDBrightness[i] = PatternLevel[i];
+  }
+  CommitLEDFrame(false);
+}
+
+// Stop any fade or generator, leaving the LEDs where they are
+static void StopPatternTick(void)
+{
+  StopTimer(TIMER_PATTERN_TICK);
+  PatternFadeLeft = 0;
+  PatternFadePending = false;
+  PatternGenerating = false;
+}
+
+// Trigger the start of an LED pattern: PATTERN_SHOW, or the next show in
+// PatternShows with PATTERN_SHOW_CYCLE
+void StartPattern(void)
+{
+  uint8_t i;
+
+  StartTimer(TIMER_PATTERN_STEP, 1);
+  PatternRunning = true;
+#if PATTERN_SHOW_CYCLE
+  PatternPC = PatternShows[PatternShow];
+  if (++PatternShow >= PATTERN_SHOW_COUNT)
+  {
+    PatternShow = 0;
+  }
+#else
+  PatternPC = PatternShows[PATTERN_SHOW];
+#endif
+  PatternLoopDepth = 0;
+  PatternSpeed = 0;
+  PatternTempoLeft = 0;
+  PatternFade = PATTERN_FADE_OFF;
+  StopPatternTick();
+  for (i=0; i < 5; i++)
+  {
+    PatternLevel[i] = 0;
+    PatternTarget[i] = 0;
+  }
+  CommitPatternLevels();
+}
+
+// Show a frame of the pattern, or with a fade on, make it the next one to fade
+// to
+static void ShowPatternFrame(const uint8_t *Frame)
+{
+  uint8_t i;
+
+  // A fade that hasn't finished by its frame's next one ends where it was
+  // going. A generator stops where it is, for the frame to fade from.
+  if (PatternFadeLeft)
+  {
+    for (i=0; i < 5; i++)
+    {
+      PatternLevel[i] = PatternTarget[i];
+    }
+  }
+  if (PatternFadeLeft || PatternGenerating)
+  {
+    StopPatternTick();
+  }
+  for (i=0; i < 5; i++)
+  {
+    PatternTarget[i] = Frame[i];
+  }
+  if (PatternFade == PATTERN_FADE_OFF)
+  {
+    PatternFadePending = false;
+    for (i=0; i < 5; i++)
+    {
+      PatternLevel[i] = Frame[i];
+    }
+    CommitPatternLevels();
+  }
+  else
+  {
+    PatternFadePending = true;
+  }
+}
+
+// Fade from PatternLevel to PatternTarget over the next Ms milliseconds
+static void StartPatternFade(uint16_t Ms)
+{
+  uint8_t i;
+
+  if (Ms > PATTERN_FADE_MAX_MS)
+  {
+    Ms = PATTERN_FADE_MAX_MS;
+  }
+  PatternFadePending = false;
+  PatternFadeMs = Ms;
+  PatternFadeLeft = Ms;
+
+  // Closing 1/2^Shift of the gap each ms leaves about e^-6 of it, under half a
+  // level, once 6 x 2^Shift ms have gone. 12 << 12 is the most that fits in 16
+  // bits, and fades that long settle well within their time anyway.
+  PatternFadeShift = 0;
+  while ((PatternFadeShift < 12) && (((uint16_t)12 << PatternFadeShift) <= Ms))
+  {
+    PatternFadeShift++;
+  }
+
+  for (i=0; i < 5; i++)
+  {
+    if (PatternFade == PATTERN_FADE_LINEAR)
+    {
+      PatternFadeDiff[i] = (PatternTarget[i] > PatternLevel[i]) ?
+                           PatternTarget[i] - PatternLevel[i] :
+                           PatternLevel[i] - PatternTarget[i];
+      PatternFadeAcc[i] = Ms >> 1;
+    }
+    else
+    {
+      PatternFadeAcc[i] = (uint16_t)PatternLevel[i] << 8;
+    }
+  }
+  StartTimer(TIMER_PATTERN_TICK, 1);
+}
+
+// Move a fade on by the millisecond TIMER_PATTERN_TICK has counted
+static void RunPatternFade(void)
+{
+  uint16_t Goal;
+  uint8_t i;
+
+  if (!PatternFadeLeft)
+  {
+    return;
+  }
+  if (--PatternFadeLeft == 0)
+  {
+    for (i=0; i < 5; i++)
+    {
+      PatternLevel[i] = PatternTarget[i];
+    }
+  }
+  else
+  {
+    StartTimer(TIMER_PATTERN_TICK, 1);
+    for (i=0; i < 5; i++)
+    {
+      if (PatternFade == PATTERN_FADE_LINEAR)
+      {
+        PatternFadeAcc[i] += PatternFadeDiff[i];
+        while (PatternFadeAcc[i] >= PatternFadeMs)
+        {
+          PatternFadeAcc[i] -= PatternFadeMs;
+          if (PatternLevel[i] < PatternTarget[i])
+          {
+            PatternLevel[i]++;
+          }
+          else
+          {
+            PatternLevel[i]--;
+          }
+        }
+      }
+      else
+      {
+        Goal = (uint16_t)PatternTarget[i] << 8;
+        if (Goal > PatternFadeAcc[i])
+        {
+          PatternFadeAcc[i] += (Goal - PatternFadeAcc[i]) >> PatternFadeShift;
+        }
+        else
+        {
+          PatternFadeAcc[i] -= (PatternFadeAcc[i] - Goal) >> PatternFadeShift;
+        }
+        PatternLevel[i] = (uint8_t)((PatternFadeAcc[i] + 0x80) >> 8);
+      }
+    }
+  }
+  CommitPatternLevels();
+}
+
+// The 16 bit operand at PatternCode[At]
+static uint16_t PatternWord(uint16_t At)
+{
+  return (uint16_t)(PatternCode[At] | ((uint16_t)PatternCode[At + 1] << 8));
+}
+
+// The sine of Phase, a full turn being 65536, as 0 to 255. 0xC000 is 0.
+static uint8_t PatternSine(uint16_t Phase)
+{
+  uint8_t Index = (uint8_t)(Phase >> 8) & 0x3F;
+
+  // The second and fourth quarters run the table backwards
+  if (Phase & 0x4000)
+  {
+    Index = 63 - Index;
+  }
+  if (Phase & 0x8000)
+  {
+    return 127 - PatternQuarterSine[Index];
+  }
+  return 128 + PatternQuarterSine[Index];
+}
+
+// Step the LFSR, returning its low byte
+static uint8_t PatternNextRandom(void)
+{
+  if (PatternRandom & 1)
+  {
+    PatternRandom = (PatternRandom >> 1) ^ 0xB400;
+  }
+  else
+  {
+    PatternRandom >>= 1;
+  }
+  return (uint8_t)PatternRandom;
+}
+
+// Start the generator instruction at PatternCode[At] making the frames, with
+// D1 at the bottom of its wave and each LED after it behind by the stagger
+static void StartPatternGenerator(uint16_t At)
+{
+  uint16_t Phase = 0xC000;
+  uint8_t i;
+
+  StopPatternTick();
+  PatternGenerating = true;
+  PatternGenerator = At;
+  for (i=0; i < 5; i++)
+  {
+    PatternPhase[i] = Phase;
+    if (PatternCode[At] == PATTERN_WAVE)
+    {
+      Phase -= PatternWord(At + 3);
+    }
+  }
+  StartTimer(TIMER_PATTERN_TICK, 1);
+}
+
+// Make the generator's next frame, when TIMER_PATTERN_TICK says it is due
+static void RunPatternGenerator(void)
+{
+  uint16_t At = PatternGenerator;
+  uint16_t Eye;
+  uint16_t Centre;
+  uint16_t Distance;
+  uint8_t i;
+
+  switch (PatternCode[At])
+  {
+    case PATTERN_WAVE:
+      StartTimer(TIMER_PATTERN_TICK, 1);
+      for (i=0; i < 5; i++)
+      {
+        PatternPhase[i] += PatternWord(At + 1);
+        PatternLevel[i] = PatternSine(PatternPhase[i]) >> PatternCode[At + 5];
+      }
+      break;
+
+    case PATTERN_SCAN:
+      // The eye swings from D1 (0) to D5 (4 x 255) and back, and each LED
+      // lights less the further it is from it
+      StartTimer(TIMER_PATTERN_TICK, 1);
+      PatternPhase[0] += PatternWord(At + 1);
+      Eye = (uint16_t)PatternSine(PatternPhase[0]) << 2;
+      Centre = 0;
+      for (i=0; i < 5; i++)
+      {
+        Distance = (Eye > Centre) ? Eye - Centre : Centre - Eye;
+        PatternLevel[i] = (Distance < 256) ?
+                          (uint8_t)(255 - Distance) >> PatternCode[At + 3] : 0;
+        Centre += 255;
+      }
+      break;
+
+    case PATTERN_FLICKER:
+      StartTimer(TIMER_PATTERN_TICK, PatternCode[At + 1]);
+      for (i=0; i < 5; i++)
+      {
+        PatternLevel[i] = PatternCode[At + 2] + (PatternNextRandom() & PatternCode[At + 3]);
+      }
       break;
-      
-    case 1:
-      if (NextPatternStepTimer == 0)
+
+    default:
+      // PATTERN_SPARKLE: the lit LEDs fade by half, and now and then one
+      // flashes. The LFSR's low bits pick which, and only 5 of the 8 light one.
+      StartTimer(TIMER_PATTERN_TICK, PatternCode[At + 1]);
+      for (i=0; i < 5; i++)
       {
-        PatternSpeed = (uint8_t)(((uint16_t)PatternSpeed * (uint16_t)8) / (uint16_t)10);
+        PatternLevel[i] >>= 1;
       }
-    case 2:
-    case 3:
-    case 4:
-    case 5:
-    case 6:
-    case 7:
-    case 8:
-      if (NextPatternStepTimer == 0)
+      if ((PatternNextRandom() & PatternCode[At + 2]) == 0)
       {
-        NextPatternStepTimer = PatternSpeed;
+        i = PatternNextRandom() & 0x07;
+        if (i < 5)
+        {
+          PatternLevel[i] = PatternCode[At + 3];
+        }
+      }
+      break;
+  }
+  CommitPatternLevels();
+}
+
+// Run the fade or generator that TIMER_PATTERN_TICK has come round for
+void RunPatternTick(void)
+{
+  if (PatternGenerating)
+  {
+    RunPatternGenerator();
+  }
+  else
+  {
+    RunPatternFade();
+  }
+}
+
+// If an LED pattern is running, run its show up to the next wait (see
+// pattern.h). Return true if pattern is still playing back, false if it's done
+bool RunPattern(void)
+{
+  uint16_t Ms;
+  uint16_t Packed;
+  uint8_t Frame[5];
+  uint8_t i;
+
+  while (PatternRunning)
+  {
+    Ms = 0;
+    switch (PatternCode[PatternPC])
+    {
+      case PATTERN_SET_FRAME:
+        for (i=0; i < 5; i++)
+        {
+          Frame[i] = PatternCode[PatternPC + 1 + i];
+        }
+        ShowPatternFrame(Frame);
+        PatternPC += 6;
+        break;
+
+      case PATTERN_WAIT:
+        Ms = PatternSpeed;
+        PatternPC++;
+        break;
+
+      case PATTERN_WAIT_MS:
+        Ms = PatternWord(PatternPC + 1);
+        PatternPC += 3;
+        break;
+
+      case PATTERN_SET_SPEED:
+        PatternSpeed = PatternWord(PatternPC + 1);
+        PatternPC += 3;
+        break;
+
+      case PATTERN_TEMPO:
+      case PATTERN_TEMPO_WIDE:
+        PatternTempoWide = (PatternCode[PatternPC] == PATTERN_TEMPO_WIDE);
+        PatternTempoLeft = PatternCode[PatternPC + 1];
+        PatternTempo = PatternPC + 2;
+        PatternPC += 2 + PatternTempoLeft;
+        if (PatternTempoWide)
+        {
+          PatternPC += PatternTempoLeft;
+        }
+        break;
+
+      case PATTERN_LOOP:
+        PatternLoopCount[PatternLoopDepth] = PatternCode[PatternPC + 1];
+        PatternPC += 2;
+        PatternLoopStart[PatternLoopDepth++] = PatternPC;
+        break;
+
+      case PATTERN_NEXT:
+        i = PatternLoopDepth - 1;
+        if ((PatternLoopCount[i] == 0) || --PatternLoopCount[i])
+        {
+          PatternPC = PatternLoopStart[i];
+        }
+        else
+        {
+          PatternLoopDepth--;
+          PatternPC++;
+        }
+        break;
 
+      case PATTERN_TEMPO_STEP:
+        if (PatternTempoLeft)
+        {
+          PatternTempoLeft--;
+          if (PatternTempoWide)
+          {
+            PatternSpeed = PatternWord(PatternTempo);
+            PatternTempo += 2;
+          }
+          else
+          {
+            PatternSpeed = PatternCode[PatternTempo++];
+          }
+          PatternPC += 3;
+        }
+        else
+        {
+          PatternLoopDepth--;
+          PatternPC = PatternWord(PatternPC + 1);
+        }
+        break;
+
+      case PATTERN_PALETTE:
+        PatternPalette = PatternPC + 2;
+        PatternPC += 2 + PatternCode[PatternPC + 1];
+        break;
+
+      case PATTERN_FRAME_2BIT:
+        // Unpacked a row at a time straight from flash, D1 first
+        Packed = PatternWord(PatternPC + 1);
         for (i=0; i < 5; i++)
         {
-          LEDBrightness[i] = Pattern[PatternState-1][i];
+          Frame[i] = PatternCode[PatternPalette + (Packed & 0x03)];
+          Packed >>= 2;
         }
+        ShowPatternFrame(Frame);
+        PatternPC += 3;
+        break;
 
-        PatternState++;
-        if (PatternState >= 9)
+      case PATTERN_FRAME_4BIT:
+        for (i=0; i < 5; i++)
         {
-          PatternState = 1;
+          Packed = PatternCode[PatternPC + 1 + (i >> 1)];
+          if (i & 1)
+          {
+            Packed >>= 4;
+          }
+          Frame[i] = PatternCode[PatternPalette + (Packed & 0x0F)];
         }
+        ShowPatternFrame(Frame);
+        PatternPC += 4;
+        break;
 
-        if (PatternSpeed < 15)
+      case PATTERN_WAVE:
+        StartPatternGenerator(PatternPC);
+        PatternPC += 6;
+        break;
+
+      case PATTERN_SCAN:
+      case PATTERN_FLICKER:
+      case PATTERN_SPARKLE:
+        StartPatternGenerator(PatternPC);
+        PatternPC += 4;
+        break;
+
+      case PATTERN_FADE:
+        // Changing the fade finishes the one under way, and shows a frame
+        // still waiting for one at once
+        if (PatternFadeLeft || PatternFadePending)
         {
-          NextPatternStepTimer = 1;
-          PatternState = 9;
-          BlinkCount = 0;
+          StopPatternTick();
+          for (i=0; i < 5; i++)
+          {
+            PatternLevel[i] = PatternTarget[i];
+          }
+          CommitPatternLevels();
         }
+        PatternFade = PatternCode[PatternPC + 1];
+        PatternPC += 2;
+        break;
+
+      default:
+        // PATTERN_END
+        PatternRunning = false;
+        StopPatternTick();
+        SetAllLEDsOff();
+        break;
+    }
+
+    // A wait of no time at all just goes on to the next instruction
+    if (Ms)
+    {
+      if (PatternFadePending)
+      {
+        StartPatternFade(Ms);
       }
-      break;
-      
-    case 9:
-      if (NextPatternStepTimer == 0)
+      StartTimer(TIMER_PATTERN_STEP, Ms);
+      return true;
+    }
+  }
+  return false;
+}
+
+#if IDLE_SLEEP
+/* True when RunTMR0 has no LED lit and none waiting in a committed frame, so
+ * TMR0 stopping in SLEEP would not show. The PWM modules keep D1-D3 going by
+ * themselves. Interrupts must be off.
+ */
+static bool SoftwarePWMDark(void)
+{
+  uint8_t i;
+
+  if (LEDFrameCommitted || (LATA & LED_SOFTWARE))
+  {
+    return false;
+  }
+  for (i=LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    if (LEDFront[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Sleep for the longest watchdog period that fits in Ms, or until an
+ * interrupt flag wakes us first, and count the time slept towards WakeTimer
+ * and the software timers. Interrupts must be off, so a flag that wakes us is
+ * serviced once they are back on.
+ */
+static void SleepFor(uint32_t Ms)
+{
+  uint8_t Period = 0;
+  uint32_t Slept = 0;
+
+  while ((Period < WDT_PERIOD_MAX) && ((2UL << Period) <= Ms))
+  {
+    Period++;
+  }
+  WDTCONbits.WDTPS = Period;
+  WDTCONbits.SWDTEN = 1;
+  // Sets nTO, and starts the period from here
+  CLRWDT();
+  SLEEP();
+  NOP();
+  WDTCONbits.SWDTEN = 0;
+
+  // Only the watchdog running out clears nTO. The watchdog's count can't be
+  // read, so a sleep cut short by the button counts as half its period, which
+  // is right on average. nPD is still set if a flag made SLEEP a NOP. The
+  // watchdog runs from LFINTOSC, so its periods are only as good as that is.
+  if (!STATUSbits.nTO)
+  {
+    Slept = 1UL << Period;
+  }
+  else if (!STATUSbits.nPD)
+  {
+    Slept = (1UL << Period) >> 1;
+  }
+  if (Slept)
+  {
+    WakeTimer += Slept;
+    AdvanceTimers(Slept);
+  }
+}
+#endif
+
+#if CLOCK_GOVERNOR
+/* Switch to the idle clock, or back to the full clock, if it isn't running
+ * already. Timer2's prescale changes with it, so its 1ms tick holds.
+ */
+static void SetIdleClock(bool Idle)
+{
+  uint8_t Shift = Idle ? CLOCK_IDLE_SHIFT : 0;
+  bool InterruptsOn;
+
+  if (Shift == ClockShift)
+  {
+    return;
+  }
+  InterruptsOn = AtomicBegin();
+  ClockShift = Shift;
+  OSCCON = Shift ? OSCCON_IDLE : OSCCON_FULL;
+  T2CONbits.T2CKPS = Shift ? T2CKPS_IDLE : T2CKPS_FULL;
+  AtomicEnd(InterruptsOn);
+}
+#endif
+
+// __delay_ms() timed for whichever clock is running
+static void DelayMs(uint16_t Ms)
+{
+  while (Ms--)
+  {
+#if CLOCK_GOVERNOR
+    if (ClockShift)
+    {
+      _delay(CYCLES_PER_MS >> CLOCK_IDLE_SHIFT);
+    }
+    else
+#endif
+    {
+      __delay_ms(1);
+    }
+  }
+}
+
+/* Wait until there's something for the main loop to do: an event in the
+ * queue, or the awake time running out while no pattern is playing. With
+ * IDLE_SLEEP it sleeps until then whenever it can.
+ */
+static void WaitForEvent(bool PlayingPattern)
+{
+  bool InterruptsOn;
+#if IDLE_SLEEP
+  uint32_t Ms;
+#endif
+
+  while (1)
+  {
+    // Interrupts stay off from looking for an event to sleeping, so one that
+    // comes in between still wakes us
+    InterruptsOn = AtomicBegin();
+    if (EventsPending() ||
+        (!PlayingPattern && (WakeTimer > MAX_AWAKE_TIME_MS)))
+    {
+      AtomicEnd(InterruptsOn);
+      return;
+    }
+#if IDLE_SLEEP
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_VERTICAL
+    // DebounceInputs needs the 1ms tick while an input is changing
+    if (SoftwarePWMDark() && !InputsSettling())
+#else
+    if (SoftwarePWMDark())
+#endif
+    {
+      // Wake a millisecond before the next timer, for the 1ms tick to expire
+      // it, or for the end of the awake time
+      Ms = TimeToNextTimer() ? TimeToNextTimer() - 1UL : UINT32_MAX;
+      if (!PlayingPattern && (MAX_AWAKE_TIME_MS + 1 - WakeTimer < Ms))
       {
-        NextPatternStepTimer = 350;
-        LEDBrightness[0] = 50;
-        LEDBrightness[1] = 0;
-        LEDBrightness[2] = 50;
-        LEDBrightness[3] = 0;
-        LEDBrightness[4] = 50;
-        PatternState = 10;
-        BlinkCount++;
+        Ms = MAX_AWAKE_TIME_MS + 1 - WakeTimer;
       }
-      break;
-      
-    case 10:
-      if (NextPatternStepTimer == 0)
+      if (Ms)
       {
-        NextPatternStepTimer = 350;
-        LEDBrightness[0] = 0;
-        LEDBrightness[1] = 50;
-        LEDBrightness[2] = 0;
-        LEDBrightness[3] = 50;
-        LEDBrightness[4] = 0;
-        PatternState = 9;
-        if (BlinkCount >= 4)
-        {
-          PatternState = 0;
-          ReturnValue = false;
-          LEDBrightness[0] = 0;
-          LEDBrightness[1] = 0;
-          LEDBrightness[2] = 0;
-          LEDBrightness[3] = 0;
-          LEDBrightness[4] = 0;
-        }
+        SleepFor(Ms);
       }
-      break;
-            
-    default:
-      ReturnValue = false;
-      break;
+    }
+#endif
+    AtomicEnd(InterruptsOn);
+    NOP();
   }
-  return ReturnValue;
 }
 
 /*
@@ -366,11 +1585,25 @@ bool RunPattern(void)
 void main(void)
 {
   static bool PlayingPattern = false;
+  Event_t Event;
+  bool InterruptsOn;
+  bool CheckButton = true;
+  bool StepPattern = true;
+  bool TickPattern = true;
 
   // initialize the device
   SYSTEM_Initialize();
 
+#if !ISR_STATIC_DISPATCH
   TMR0_SetInterruptHandler(RunTMR0);
+  TMR2_SetInterruptHandler(RunOneMSTasks);
+  IOCAF3_SetInterruptHandler(ButtonChanged);
+#endif
+
+#if IDLE_SLEEP
+  // Sleep in low power mode between events, as for the long sleep below
+  VREGCONbits.VREGPM = 1;
+#endif
 
   // When using interrupts, you need to set the Global and Peripheral Interrupt Enable bits
   // Use the following macros to:
@@ -390,11 +1623,76 @@ void main(void)
   /// Are these really needed? Probably not
   TRISA = TRISA_LEDS_ALL_OUTUPT;
   PORTA = PORTA_LEDS_ALL_LOW;
+
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+  // Take the button's state from the pin as if it had just changed. Its IOC
+  // flag can be set from software, which has the ISR call ButtonChanged.
+  IOCAFbits.IOCAF3 = 1;
+#endif
   
+  // Go round once at the start, then each time WaitForEvent returns
   while (1)
   {  
-    CheckForButtonPushes();
-    PlayingPattern = RunPattern();
+    // Look only at what the events say has changed. Everything is looked at
+    // the first time round, and again if any events were lost.
+    if (TakeEventsLost())
+    {
+      CheckButton = true;
+      StepPattern = true;
+      TickPattern = true;
+    }
+    while (TakeEvent(&Event))
+    {
+      switch (Event.Type)
+      {
+        case EVENT_TIMER_EXPIRED:
+          if (Event.Data == TIMER_PATTERN_STEP)
+          {
+            StepPattern = true;
+          }
+          else if (Event.Data == TIMER_PATTERN_TICK)
+          {
+            TickPattern = true;
+          }
+          else if (Event.Data == TIMER_DEBOUNCE)
+          {
+            CheckButton = true;
+          }
+          break;
+
+        case EVENT_BUTTON_EDGE:
+        case EVENT_INPUTS_CHANGED:
+          CheckButton = true;
+          break;
+
+        default:
+          // Nothing asks for EVENT_FRAME_DONE yet
+          break;
+      }
+    }
+
+    if (CheckButton)
+    {
+      CheckButton = false;
+      CheckForButtonPushes();
+    }
+    // A fade's last millisecond lands on its frame before the next step
+    if (TickPattern)
+    {
+      TickPattern = false;
+      if (TimerExpired(TIMER_PATTERN_TICK))
+      {
+        RunPatternTick();
+      }
+    }
+    if (StepPattern)
+    {
+      StepPattern = false;
+      if (TimerExpired(TIMER_PATTERN_STEP))
+      {
+        PlayingPattern = RunPattern();
+      }
+    }
     
     // If we're not already playing a pattern, has the user pressed the button?
     if (!PlayingPattern && ButtonPressed())
@@ -403,31 +1701,44 @@ void main(void)
       StartPattern();
     }
 
-    if (!PlayingPattern && (WakeTimer > MAX_AWAKE_TIME_MS))
+    if (!PlayingPattern && (ReadShared32(&WakeTimer) > MAX_AWAKE_TIME_MS))
     {
       SetAllLEDsOff();
       // Allow off command to percolate to LEDs (maximum 32ms)
-      __delay_ms(50);
+      DelayMs(50);
 
       // For SHUTDOWN_DELAY_MS, check to see if user has pressed the button just as we're trying to go to sleep
-      ShutdownDelayTimer = SHUTDOWN_DELAY_MS;
+      StartTimer(TIMER_SHUTDOWN_DELAY, SHUTDOWN_DELAY_MS);
 
-      while (ShutdownDelayTimer && !CheckForButtonPushes())
+      while (!TimerExpired(TIMER_SHUTDOWN_DELAY) && !CheckForButtonPushes())
       {
       }
 
-      // If the button was not pushed, this timer will be at zero, and it's time to sleep
-      if (ShutdownDelayTimer == 0)
+      // If the button was not pushed, this timer will have expired, and it's time to sleep
+      if (TimerExpired(TIMER_SHUTDOWN_DELAY))
       {
           // Hit the VREGPM bit to put us in low power sleep mode
         VREGCONbits.VREGPM = 1;
 
         SLEEP();
 
-        // Start off with time = 0;
+        // Start off with time = 0, keeping the edge that woke us as old as
+        // it was
+        InterruptsOn = AtomicBegin();
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+        ButtonEdgeTime -= WakeTimer;
+#endif
         WakeTimer = 0;
+        AtomicEnd(InterruptsOn);
       }
     }
+
+#if CLOCK_GOVERNOR
+    // Run slowly while there's nothing to show and no press to time
+    SetIdleClock(!PlayingPattern && (ButtonState == BUTTON_STATE_RELEASED));
+#endif
+
+    WaitForEvent(PlayingPattern);
   }
 }
 /**
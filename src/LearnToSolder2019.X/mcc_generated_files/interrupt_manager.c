@@ -47,22 +47,190 @@
 
 #include "interrupt_manager.h"
 #include "mcc.h"
+#include "../app_config.h"
+
+#if ISR_STATIC_DISPATCH
+// The handlers bound in app_config.h
+void ISR_TMR0_HANDLER(void);
+void ISR_TMR2_HANDLER(void);
+#ifdef ISR_IOCAF2_HANDLER
+void ISR_IOCAF2_HANDLER(void);
+#endif
+#ifdef ISR_IOCAF3_HANDLER
+void ISR_IOCAF3_HANDLER(void);
+#endif
+#endif
+
+#if ISR_SERVICE_ALL
+// Go on to test the next source whether or not this one was serviced
+#define INTERRUPT_NEXT_SOURCE
+#else
+// Service only the first pending source, in priority order
+#define INTERRUPT_NEXT_SOURCE   else
+#endif
+
+#ifdef ISR_PROFILE
+volatile INTERRUPT_PROFILE INTERRUPT_Profile;
+
+static uint16_t profileLastStart;
+
+// Timer1 has no 16 bit read latch, so re-read if the low byte rolled over.
+// The ISR reads it through this rather than INTERRUPT_ProfileTimer(), which
+// mainline calls, as XC8 would make a second copy of a function both call.
+#define PROFILE_READ_TIMER1(count)                              \
+    do                                                          \
+    {                                                           \
+        uint8_t high_ = TMR1H;                                  \
+        uint8_t low_ = TMR1L;                                   \
+                                                                \
+        if (TMR1H != high_)                                     \
+        {                                                       \
+            high_ = TMR1H;                                      \
+            low_ = TMR1L;                                       \
+        }                                                       \
+        (count) = (uint16_t)(((uint16_t)high_ << 8) | low_);    \
+    } while (0)
+
+void INTERRUPT_ProfileInitialize(void)
+{
+    // TMR1CS FOSC/4; T1CKPS 1:1; TMR1ON enabled;
+    T1CON = 0x01;
+
+    INTERRUPT_Profile.BestCycles = 0xFFFF;
+    INTERRUPT_Profile.WorstCycles = 0;
+    INTERRUPT_Profile.Samples = 0;
+    INTERRUPT_Profile.IsrCycles = 0;
+    INTERRUPT_Profile.TotalCycles = 0;
+    INTERRUPT_Profile.Tmr0WorstLatency = 0;
+    INTERRUPT_Profile.Tmr2WorstLatency = 0;
+    INTERRUPT_Profile.MaskWorstCycles = 0;
+    profileLastStart = INTERRUPT_ProfileTimer();
+}
+
+uint16_t INTERRUPT_ProfileTimer(void)
+{
+    uint16_t count;
+
+    PROFILE_READ_TIMER1(count);
+    return count;
+}
+
+static void INTERRUPT_ProfileRecord(uint16_t start)
+{
+    uint16_t cycles;
+
+    PROFILE_READ_TIMER1(cycles);
+    cycles -= start;
+
+    if (cycles < INTERRUPT_Profile.BestCycles)
+    {
+        INTERRUPT_Profile.BestCycles = cycles;
+    }
+    if (cycles > INTERRUPT_Profile.WorstCycles)
+    {
+        INTERRUPT_Profile.WorstCycles = cycles;
+    }
+    if (INTERRUPT_Profile.Samples != 0xFFFF)
+    {
+        INTERRUPT_Profile.Samples++;
+        INTERRUPT_Profile.IsrCycles += cycles;
+        INTERRUPT_Profile.TotalCycles += (uint16_t)(start - profileLastStart);
+    }
+    profileLastStart = start;
+}
+
+void INTERRUPT_ProfileMask(uint16_t start)
+{
+    uint16_t cycles = INTERRUPT_ProfileTimer() - start;
+
+    if (cycles > INTERRUPT_Profile.MaskWorstCycles)
+    {
+        INTERRUPT_Profile.MaskWorstCycles = cycles;
+    }
+}
+
+// The timer has counted up from 0 since its flag was set
+static void INTERRUPT_ProfileLatency(volatile uint8_t *worst, uint8_t count)
+{
+    if (count > *worst)
+    {
+        *worst = count;
+    }
+}
+#endif
 
 void __interrupt() INTERRUPT_InterruptManager (void)
 {
+#ifdef ISR_PROFILE
+    uint16_t profileStart;
+
+    PROFILE_READ_TIMER1(profileStart);
+#endif
+
     // interrupt handler
     if(INTCONbits.TMR0IE == 1 && INTCONbits.TMR0IF == 1)
     {
+#ifdef ISR_PROFILE
+        INTERRUPT_ProfileLatency(&INTERRUPT_Profile.Tmr0WorstLatency, TMR0);
+#endif
+#if ISR_STATIC_DISPATCH
+        // TMR0_ISR
+        INTCONbits.TMR0IF = 0;
+#if PWM_ENGINE == PWM_ENGINE_BAM
+        // Reload a whole BAM unit after the overflow, as TMR0_ISR does
+        _delay(BAM_UNIT_CYCLES - TMR0_RELOAD_LATENCY);
+#endif
+        TMR0 = timer0ReloadVal;
+        ISR_TMR0_HANDLER();
+#else
         TMR0_ISR();
+#endif
     }
-    else if(INTCONbits.IOCIE == 1 && INTCONbits.IOCIF == 1)
+    INTERRUPT_NEXT_SOURCE if(INTCONbits.IOCIE == 1 && INTCONbits.IOCIF == 1)
     {
+#if ISR_STATIC_DISPATCH
+        // PIN_MANAGER_IOC, IOCAF2_ISR and IOCAF3_ISR
+        if(IOCAFbits.IOCAF2 == 1)
+        {
+#ifdef ISR_IOCAF2_HANDLER
+            ISR_IOCAF2_HANDLER();
+#endif
+            IOCAFbits.IOCAF2 = 0;
+        }
+        if(IOCAFbits.IOCAF3 == 1)
+        {
+#ifdef ISR_IOCAF3_HANDLER
+            ISR_IOCAF3_HANDLER();
+#endif
+            IOCAFbits.IOCAF3 = 0;
+        }
+#else
         PIN_MANAGER_IOC();
+#endif
     }
+    INTERRUPT_NEXT_SOURCE if(INTCONbits.PEIE == 1 && PIE1bits.TMR2IE == 1 && PIR1bits.TMR2IF == 1)
+    {
+#ifdef ISR_PROFILE
+        INTERRUPT_ProfileLatency(&INTERRUPT_Profile.Tmr2WorstLatency, TMR2);
+#endif
+#if ISR_STATIC_DISPATCH
+        // TMR2_ISR
+        PIR1bits.TMR2IF = 0;
+        ISR_TMR2_HANDLER();
+#else
+        TMR2_ISR();
+#endif
+    }
+#if !ISR_SERVICE_ALL
     else
     {
         //Unhandled Interrupt
     }
+#endif
+
+#ifdef ISR_PROFILE
+    INTERRUPT_ProfileRecord(profileStart);
+#endif
 }
 /**
  End of File
@@ -48,6 +48,12 @@
 #ifndef INTERRUPT_MANAGER_H
 #define INTERRUPT_MANAGER_H
 
+#include <stdint.h>
+
+// Define ISR_PROFILE, for example in the project's compiler options, to
+// profile every interrupt with Timer1. It adds to every interrupt and takes
+// Timer1, so no build has it unless asked, debug builds included.
+
 
 /**
  * @Param
@@ -107,6 +113,89 @@
  */
 void __interrupt() INTERRUPT_InterruptManager(void);
 
+#ifdef ISR_PROFILE
+/**
+ * Interrupt profile, filled in by INTERRUPT_InterruptManager and read back
+ * with the debugger (or the MPLAB simulator).
+ *
+ * Timer1 runs at Fosc/4, so every count is one instruction cycle. Each sample
+ * covers INTERRUPT_InterruptManager from its first to its last statement, so
+ * add about 6 cycles of latency, context save and RETFIE for the whole cost.
+ *
+ *   best cycles      BestCycles
+ *   typical cycles   IsrCycles / Samples
+ *   worst cycles     WorstCycles
+ *   mainline share   1 - IsrCycles / TotalCycles
+ *
+ * The sums stop once Samples reaches 0xFFFF so they can't overflow; best and
+ * worst keep being updated.
+ *
+ * Tmr0WorstLatency and Tmr2WorstLatency are the most timer counts seen to pass
+ * between a timer setting its interrupt flag and INTERRUPT_InterruptManager
+ * getting to it. Multiply by the TMR0 prescale, or by Timer2's prescale, for
+ * instruction cycles. Timer2's is 1:16, or 1:4 while CLOCK_GOVERNOR has the
+ * idle clock running, so its figure is only in one unit if the clock stayed
+ * the same. IOC has no timer to read, so only the host simulator measures
+ * its latency.
+ *
+ * MaskWorstCycles is the longest mainline has kept interrupts off between
+ * AtomicBegin() and AtomicEnd() (see atomic.h), which every interrupt may have
+ * to wait on top of its latency. Add about 4 cycles for the calls themselves.
+ */
+typedef struct
+{
+    uint16_t BestCycles;
+    uint16_t WorstCycles;
+    uint16_t Samples;
+    uint32_t IsrCycles;
+    uint32_t TotalCycles;
+    uint8_t Tmr0WorstLatency;
+    uint8_t Tmr2WorstLatency;
+    uint16_t MaskWorstCycles;
+} INTERRUPT_PROFILE;
+
+extern volatile INTERRUPT_PROFILE INTERRUPT_Profile;
+
+/**
+ * @Param
+    none
+ * @Returns
+    none
+ * @Description
+    Starts Timer1 as a free running instruction cycle counter and clears the
+    interrupt profile.
+ * @Example
+    INTERRUPT_ProfileInitialize();
+ */
+void INTERRUPT_ProfileInitialize(void);
+
+/**
+ * @Param
+    none
+ * @Returns
+    Timer1, the instruction cycle count the profile is taken from
+ * @Description
+    Reads Timer1 for the start of a section INTERRUPT_ProfileMask will time.
+    Mainline only.
+ * @Example
+    start = INTERRUPT_ProfileTimer();
+ */
+uint16_t INTERRUPT_ProfileTimer(void);
+
+/**
+ * @Param
+    start - INTERRUPT_ProfileTimer() from when interrupts were turned off
+ * @Returns
+    none
+ * @Description
+    Records how long mainline has had interrupts off, just before it turns
+    them back on.
+ * @Example
+    INTERRUPT_ProfileMask(start);
+ */
+void INTERRUPT_ProfileMask(uint16_t start);
+#endif
+
 
 #endif  // INTERRUPT_MANAGER_H
 /**
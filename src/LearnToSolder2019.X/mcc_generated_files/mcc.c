@@ -43,11 +43,17 @@
     TERMS.
 */
 
+#include "../app_config.h"
+
 // Configuration bits: selected in the GUI
 
 // CONFIG1
 #pragma config FOSC = INTOSC    // ->INTOSC oscillator; I/O function on CLKIN pin
+#if IDLE_SLEEP
+#pragma config WDTE = SWDTEN    // Watchdog Timer Enable->WDT controlled by the SWDTEN bit in the WDTCON register
+#else
 #pragma config WDTE = OFF    // Watchdog Timer Enable->WDT disabled
+#endif
 #pragma config PWRTE = OFF    // Power-up Timer Enable->PWRT disabled
 #pragma config MCLRE = OFF    // MCLR Pin Function Select->MCLR/VPP pin function is digital input
 #pragma config CP = OFF    // Flash Program Memory Code Protection->Program memory code protection is disabled
@@ -72,6 +78,15 @@ void SYSTEM_Initialize(void)
     OSCILLATOR_Initialize();
     WDT_Initialize();
     TMR0_Initialize();
+    TMR2_Initialize();
+#if LED_HW_PWM
+    PWM1_Initialize();
+    PWM2_Initialize();
+    PWM3_Initialize();
+#endif
+#ifdef ISR_PROFILE
+    INTERRUPT_ProfileInitialize();
+#endif
 }
 
 void OSCILLATOR_Initialize(void)
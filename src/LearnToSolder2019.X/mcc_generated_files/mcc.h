@@ -51,6 +51,10 @@
 #include <stdbool.h>
 #include "interrupt_manager.h"
 #include "tmr0.h"
+#include "tmr2.h"
+#include "pwm1.h"
+#include "pwm2.h"
+#include "pwm3.h"
 
 #define _XTAL_FREQ  16000000
 
@@ -46,6 +46,7 @@
 #include <xc.h>
 #include "pin_manager.h"
 #include "stdbool.h"
+#include "../app_config.h"
 
 
 void (*IOCAF2_InterruptHandler)(void);
@@ -83,6 +84,7 @@ void PIN_MANAGER_Initialize(void)
     /**
     APFCONx registers
     */
+    // P1SEL RA1; P2SEL RA0;
     APFCON = 0x00;
 
     /**
@@ -91,11 +93,20 @@ void PIN_MANAGER_Initialize(void)
     // interrupt on change for group IOCAF - flag
     IOCAFbits.IOCAF2 = 0;
     IOCAFbits.IOCAF3 = 0;
+#if LED_HW_PWM
+    // RA2 is PWM3's output, so leave IOC off there rather than taking an
+    // interrupt on every PWM edge
+    IOCANbits.IOCAN2 = 0;
+    IOCAPbits.IOCAP2 = 0;
+#else
     // interrupt on change for group IOCAN - negative
     IOCANbits.IOCAN2 = 1;
-    IOCANbits.IOCAN3 = 1;
     // interrupt on change for group IOCAP - positive
     IOCAPbits.IOCAP2 = 1;
+#endif
+    // interrupt on change for group IOCAN - negative
+    IOCANbits.IOCAN3 = 1;
+    // interrupt on change for group IOCAP - positive
     IOCAPbits.IOCAP3 = 1;
 
     // register default IOC callback functions at runtime; use these methods to register a custom function
@@ -0,0 +1,147 @@
+/**
+  PWM1 Generated Driver File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    pwm1.c
+
+  @Summary
+    This is the generated driver implementation file for the PWM1 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This source file provides APIs for PWM1.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.65
+        Device            :  PIC12F1572
+        Driver Version    :  2.00
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 1.45
+        MPLAB 	          :  MPLAB X 4.10
+*/
+
+/*
+    (c) 2016 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include "pwm1.h"
+#include "../app_config.h"
+
+/**
+  Section: PWM1 APIs
+*/
+
+void PWM1_Initialize(void)
+{
+    // Set the PWM1 to the options selected in the User Interface
+
+    // PWM1MODE standard_PWM; PWM1POL active_hi; PWM1OE enabled; PWM1EN disabled
+    PWM1CON = 0x40;
+
+    // PWM1PRIE disabled; PWM1DCIE disabled; PWM1PHIE disabled; PWM1OFIE disabled
+    PWM1INTE = 0x00;
+
+    // PWM1PRIF cleared; PWM1DCIF cleared; PWM1PHIF cleared; PWM1OFIF cleared
+    PWM1INTF = 0x00;
+
+#if IDLE_SLEEP
+    // PWM1PS No_Prescalar; PWM1CS LFINTOSC, which keeps running in Sleep
+    PWM1CLKCON = 0x02;
+#else
+    // PWM1PS No_Prescalar; PWM1CS FOSC
+    PWM1CLKCON = 0x00;
+#endif
+
+    // PWM1LDS reserved; PWM1LDT disabled; PWM1LDA do_not_load
+    PWM1LDCON = 0x00;
+
+    // PWM1OFM independent_run
+    PWM1OFCON = 0x00;
+
+    // PWM1PH 0
+    PWM1PHH = 0x00;
+    PWM1PHL = 0x00;
+
+    // PWM1DC 0
+    PWM1DCH = 0x00;
+    PWM1DCL = 0x00;
+
+#if IDLE_SLEEP
+    // PWM1PR 255
+    PWM1PRH = 0x00;
+    PWM1PRL = 0xFF;
+#else
+    // PWM1PR 65535
+    PWM1PRH = 0xFF;
+    PWM1PRL = 0xFF;
+#endif
+
+    // Load the buffers and start the counter
+    PWM1_LoadBufferSet();
+    PWM1_Start();
+}
+
+void PWM1_Start(void)
+{
+    PWM1CONbits.EN = 1;
+}
+
+void PWM1_Stop(void)
+{
+    PWM1CONbits.EN = 0;
+}
+
+bool PWM1_CheckOutputStatus(void)
+{
+    return (PWM1CONbits.OUT);
+}
+
+void PWM1_LoadBufferSet(void)
+{
+    PWM1LDCONbits.LDA = 1;
+}
+
+void PWM1_PhaseSet(uint16_t phaseCount)
+{
+    PWM1PHH = (uint8_t)(phaseCount >> 8);
+    PWM1PHL = (uint8_t)phaseCount;
+}
+
+void PWM1_DutyCycleSet(uint16_t dutyCycleCount)
+{
+    PWM1DCH = (uint8_t)(dutyCycleCount >> 8);
+    PWM1DCL = (uint8_t)dutyCycleCount;
+}
+
+void PWM1_PeriodSet(uint16_t periodCount)
+{
+    PWM1PRH = (uint8_t)(periodCount >> 8);
+    PWM1PRL = (uint8_t)periodCount;
+}
+/**
+  End of File
+*/
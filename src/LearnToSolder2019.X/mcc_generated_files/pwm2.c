@@ -0,0 +1,147 @@
+/**
+  PWM2 Generated Driver File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    pwm2.c
+
+  @Summary
+    This is the generated driver implementation file for the PWM2 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This source file provides APIs for PWM2.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.65
+        Device            :  PIC12F1572
+        Driver Version    :  2.00
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 1.45
+        MPLAB 	          :  MPLAB X 4.10
+*/
+
+/*
+    (c) 2016 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include "pwm2.h"
+#include "../app_config.h"
+
+/**
+  Section: PWM2 APIs
+*/
+
+void PWM2_Initialize(void)
+{
+    // Set the PWM2 to the options selected in the User Interface
+
+    // PWM2MODE standard_PWM; PWM2POL active_hi; PWM2OE enabled; PWM2EN disabled
+    PWM2CON = 0x40;
+
+    // PWM2PRIE disabled; PWM2DCIE disabled; PWM2PHIE disabled; PWM2OFIE disabled
+    PWM2INTE = 0x00;
+
+    // PWM2PRIF cleared; PWM2DCIF cleared; PWM2PHIF cleared; PWM2OFIF cleared
+    PWM2INTF = 0x00;
+
+#if IDLE_SLEEP
+    // PWM2PS No_Prescalar; PWM2CS LFINTOSC, which keeps running in Sleep
+    PWM2CLKCON = 0x02;
+#else
+    // PWM2PS No_Prescalar; PWM2CS FOSC
+    PWM2CLKCON = 0x00;
+#endif
+
+    // PWM2LDS reserved; PWM2LDT disabled; PWM2LDA do_not_load
+    PWM2LDCON = 0x00;
+
+    // PWM2OFM independent_run
+    PWM2OFCON = 0x00;
+
+    // PWM2PH 0
+    PWM2PHH = 0x00;
+    PWM2PHL = 0x00;
+
+    // PWM2DC 0
+    PWM2DCH = 0x00;
+    PWM2DCL = 0x00;
+
+#if IDLE_SLEEP
+    // PWM2PR 255
+    PWM2PRH = 0x00;
+    PWM2PRL = 0xFF;
+#else
+    // PWM2PR 65535
+    PWM2PRH = 0xFF;
+    PWM2PRL = 0xFF;
+#endif
+
+    // Load the buffers and start the counter
+    PWM2_LoadBufferSet();
+    PWM2_Start();
+}
+
+void PWM2_Start(void)
+{
+    PWM2CONbits.EN = 1;
+}
+
+void PWM2_Stop(void)
+{
+    PWM2CONbits.EN = 0;
+}
+
+bool PWM2_CheckOutputStatus(void)
+{
+    return (PWM2CONbits.OUT);
+}
+
+void PWM2_LoadBufferSet(void)
+{
+    PWM2LDCONbits.LDA = 1;
+}
+
+void PWM2_PhaseSet(uint16_t phaseCount)
+{
+    PWM2PHH = (uint8_t)(phaseCount >> 8);
+    PWM2PHL = (uint8_t)phaseCount;
+}
+
+void PWM2_DutyCycleSet(uint16_t dutyCycleCount)
+{
+    PWM2DCH = (uint8_t)(dutyCycleCount >> 8);
+    PWM2DCL = (uint8_t)dutyCycleCount;
+}
+
+void PWM2_PeriodSet(uint16_t periodCount)
+{
+    PWM2PRH = (uint8_t)(periodCount >> 8);
+    PWM2PRL = (uint8_t)periodCount;
+}
+/**
+  End of File
+*/
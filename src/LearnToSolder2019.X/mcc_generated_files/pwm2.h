@@ -0,0 +1,219 @@
+/**
+  PWM2 Generated Driver API Header File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    pwm2.h
+
+  @Summary
+    This is the generated header file for the PWM2 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This header file provides APIs for PWM2.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.65
+        Device            :  PIC12F1572
+        Driver Version    :  2.00
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 1.45
+        MPLAB 	          :  MPLAB X 4.10
+*/
+
+/*
+    (c) 2016 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+#ifndef _PWM2_H
+#define _PWM2_H
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+
+/**
+  Section: PWM2 APIs
+*/
+
+/**
+  @Summary
+    Initializes the PWM2 module.
+
+  @Description
+    This function initializes the PWM2 registers and starts the module:
+    standard mode, active high output on RA0 (RA4 with APFCON P2SEL set),
+    clocked from FOSC with no prescale and a 16 bit period (0xFFFF, 244 Hz
+    at 16 MHz). The duty cycle starts at 0.
+
+  @Preconditions
+    None
+
+  @Param
+    None
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    PWM2_Initialize();
+    </code>
+*/
+void PWM2_Initialize(void);
+
+/**
+  @Summary
+    Starts the PWM2 counter.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void PWM2_Start(void);
+
+/**
+  @Summary
+    Stops the PWM2 counter.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void PWM2_Stop(void);
+
+/**
+  @Summary
+    Returns the current level of the PWM2 output.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    true - output high
+    false - output low
+*/
+bool PWM2_CheckOutputStatus(void);
+
+/**
+  @Summary
+    Loads the buffered PWM2 phase, duty cycle and period.
+
+  @Description
+    The values written by PWM2_PhaseSet(), PWM2_DutyCycleSet() and
+    PWM2_PeriodSet() take effect together at the end of the current
+    period, once this has been called.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    PWM2_DutyCycleSet(0x8000);
+    PWM2_LoadBufferSet();
+    </code>
+*/
+void PWM2_LoadBufferSet(void);
+
+/**
+  @Summary
+    Sets the PWM2 phase count, where the output goes active.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    phaseCount - 16 bit phase count
+
+  @Returns
+    None
+*/
+void PWM2_PhaseSet(uint16_t phaseCount);
+
+/**
+  @Summary
+    Sets the PWM2 duty cycle count, where the output goes inactive.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    dutyCycleCount - 16 bit duty cycle count
+
+  @Returns
+    None
+*/
+void PWM2_DutyCycleSet(uint16_t dutyCycleCount);
+
+/**
+  @Summary
+    Sets the PWM2 period count.
+
+  @Preconditions
+    PWM2_Initialize() function should have been called before calling this function.
+
+  @Param
+    periodCount - 16 bit period count; the period is periodCount + 1 clocks
+
+  @Returns
+    None
+*/
+void PWM2_PeriodSet(uint16_t periodCount);
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+
+#endif // _PWM2_H
+/**
+ End of File
+*/
@@ -0,0 +1,147 @@
+/**
+  PWM3 Generated Driver File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    pwm3.c
+
+  @Summary
+    This is the generated driver implementation file for the PWM3 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This source file provides APIs for PWM3.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.65
+        Device            :  PIC12F1572
+        Driver Version    :  2.00
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 1.45
+        MPLAB 	          :  MPLAB X 4.10
+*/
+
+/*
+    (c) 2016 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include "pwm3.h"
+#include "../app_config.h"
+
+/**
+  Section: PWM3 APIs
+*/
+
+void PWM3_Initialize(void)
+{
+    // Set the PWM3 to the options selected in the User Interface
+
+    // PWM3MODE standard_PWM; PWM3POL active_hi; PWM3OE enabled; PWM3EN disabled
+    PWM3CON = 0x40;
+
+    // PWM3PRIE disabled; PWM3DCIE disabled; PWM3PHIE disabled; PWM3OFIE disabled
+    PWM3INTE = 0x00;
+
+    // PWM3PRIF cleared; PWM3DCIF cleared; PWM3PHIF cleared; PWM3OFIF cleared
+    PWM3INTF = 0x00;
+
+#if IDLE_SLEEP
+    // PWM3PS No_Prescalar; PWM3CS LFINTOSC, which keeps running in Sleep
+    PWM3CLKCON = 0x02;
+#else
+    // PWM3PS No_Prescalar; PWM3CS FOSC
+    PWM3CLKCON = 0x00;
+#endif
+
+    // PWM3LDS reserved; PWM3LDT disabled; PWM3LDA do_not_load
+    PWM3LDCON = 0x00;
+
+    // PWM3OFM independent_run
+    PWM3OFCON = 0x00;
+
+    // PWM3PH 0
+    PWM3PHH = 0x00;
+    PWM3PHL = 0x00;
+
+    // PWM3DC 0
+    PWM3DCH = 0x00;
+    PWM3DCL = 0x00;
+
+#if IDLE_SLEEP
+    // PWM3PR 255
+    PWM3PRH = 0x00;
+    PWM3PRL = 0xFF;
+#else
+    // PWM3PR 65535
+    PWM3PRH = 0xFF;
+    PWM3PRL = 0xFF;
+#endif
+
+    // Load the buffers and start the counter
+    PWM3_LoadBufferSet();
+    PWM3_Start();
+}
+
+void PWM3_Start(void)
+{
+    PWM3CONbits.EN = 1;
+}
+
+void PWM3_Stop(void)
+{
+    PWM3CONbits.EN = 0;
+}
+
+bool PWM3_CheckOutputStatus(void)
+{
+    return (PWM3CONbits.OUT);
+}
+
+void PWM3_LoadBufferSet(void)
+{
+    PWM3LDCONbits.LDA = 1;
+}
+
+void PWM3_PhaseSet(uint16_t phaseCount)
+{
+    PWM3PHH = (uint8_t)(phaseCount >> 8);
+    PWM3PHL = (uint8_t)phaseCount;
+}
+
+void PWM3_DutyCycleSet(uint16_t dutyCycleCount)
+{
+    PWM3DCH = (uint8_t)(dutyCycleCount >> 8);
+    PWM3DCL = (uint8_t)dutyCycleCount;
+}
+
+void PWM3_PeriodSet(uint16_t periodCount)
+{
+    PWM3PRH = (uint8_t)(periodCount >> 8);
+    PWM3PRL = (uint8_t)periodCount;
+}
+/**
+  End of File
+*/
@@ -0,0 +1,219 @@
+/**
+  PWM3 Generated Driver API Header File
+
+  @Company
+    Microchip Technology Inc.
+
+  @File Name
+    pwm3.h
+
+  @Summary
+    This is the generated header file for the PWM3 driver using PIC10 / PIC12 / PIC16 / PIC18 MCUs
+
+  @Description
+    This header file provides APIs for PWM3.
+    Generation Information :
+        Product Revision  :  PIC10 / PIC12 / PIC16 / PIC18 MCUs - 1.65
+        Device            :  PIC12F1572
+        Driver Version    :  2.00
+    The generated drivers are tested against the following:
+        Compiler          :  XC8 1.45
+        MPLAB 	          :  MPLAB X 4.10
+*/
+
+/*
+    (c) 2016 Microchip Technology Inc. and its subsidiaries. You may use this
+    software and any derivatives exclusively with Microchip products.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE, OR ITS INTERACTION WITH MICROCHIP PRODUCTS, COMBINATION
+    WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+    WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+    BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+    FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+    ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+    THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF THESE
+    TERMS.
+*/
+
+#ifndef _PWM3_H
+#define _PWM3_H
+
+/**
+  Section: Included Files
+*/
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+
+/**
+  Section: PWM3 APIs
+*/
+
+/**
+  @Summary
+    Initializes the PWM3 module.
+
+  @Description
+    This function initializes the PWM3 registers and starts the module:
+    standard mode, active high output on RA2, clocked from FOSC with no
+    prescale and a 16 bit period (0xFFFF, 244 Hz at 16 MHz). The duty cycle
+    starts at 0.
+
+  @Preconditions
+    None
+
+  @Param
+    None
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    PWM3_Initialize();
+    </code>
+*/
+void PWM3_Initialize(void);
+
+/**
+  @Summary
+    Starts the PWM3 counter.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void PWM3_Start(void);
+
+/**
+  @Summary
+    Stops the PWM3 counter.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+*/
+void PWM3_Stop(void);
+
+/**
+  @Summary
+    Returns the current level of the PWM3 output.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    true - output high
+    false - output low
+*/
+bool PWM3_CheckOutputStatus(void);
+
+/**
+  @Summary
+    Loads the buffered PWM3 phase, duty cycle and period.
+
+  @Description
+    The values written by PWM3_PhaseSet(), PWM3_DutyCycleSet() and
+    PWM3_PeriodSet() take effect together at the end of the current
+    period, once this has been called.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    None
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    PWM3_DutyCycleSet(0x8000);
+    PWM3_LoadBufferSet();
+    </code>
+*/
+void PWM3_LoadBufferSet(void);
+
+/**
+  @Summary
+    Sets the PWM3 phase count, where the output goes active.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    phaseCount - 16 bit phase count
+
+  @Returns
+    None
+*/
+void PWM3_PhaseSet(uint16_t phaseCount);
+
+/**
+  @Summary
+    Sets the PWM3 duty cycle count, where the output goes inactive.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    dutyCycleCount - 16 bit duty cycle count
+
+  @Returns
+    None
+*/
+void PWM3_DutyCycleSet(uint16_t dutyCycleCount);
+
+/**
+  @Summary
+    Sets the PWM3 period count.
+
+  @Preconditions
+    PWM3_Initialize() function should have been called before calling this function.
+
+  @Param
+    periodCount - 16 bit period count; the period is periodCount + 1 clocks
+
+  @Returns
+    None
+*/
+void PWM3_PeriodSet(uint16_t periodCount);
+
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    }
+
+#endif
+
+#endif // _PWM3_H
+/**
+ End of File
+*/
@@ -49,6 +49,8 @@
 
 #include <xc.h>
 #include "tmr0.h"
+#include "mcc.h"
+#include "../app_config.h"
 
 /**
   Section: Global Variables Definitions
@@ -60,15 +62,71 @@ void (*TMR0_InterruptHandler)(void);
   Section: TMR0 APIs
 */
 
+#if PWM_ENGINE == PWM_ENGINE_EDGE
+// One TMR0 count per PWM step; the interrupt handler sets each reload value
+#define TMR0_OPTION (0xD6)        // PSA assigned; PS 1:128
+#define TMR0_RELOAD (0x00)
+#elif PWM_ENGINE == PWM_ENGINE_BAM
+// One TMR0 count per BAM unit; the first period is the bit 0-2 slot
+#if BAM_UNIT_CYCLES == 32
+#define TMR0_OPTION (0xD4)        // PSA assigned; PS 1:32
+#elif BAM_UNIT_CYCLES == 64
+#define TMR0_OPTION (0xD5)        // PSA assigned; PS 1:64
+#elif BAM_UNIT_CYCLES == 128
+#define TMR0_OPTION (0xD6)        // PSA assigned; PS 1:128
+#else
+#error BAM_UNIT_CYCLES must be 32, 64 or 128
+#endif
+// One count short of the 7 unit first slot, as TMR0_ISR reloads a unit late
+#define TMR0_RELOAD (0xFA)
+#elif PWM_ENGINE == PWM_ENGINE_DITHER
+// One TMR0 period per dither step, with the smallest prescale that fits it
+#if DITHER_STEP_CYCLES <= 256
+#define TMR0_OPTION (0xD8)        // PSA not assigned
+#define TMR0_PRESCALE 1
+#elif DITHER_STEP_CYCLES <= 512
+#define TMR0_OPTION (0xD0)        // PSA assigned; PS 1:2
+#define TMR0_PRESCALE 2
+#elif DITHER_STEP_CYCLES <= 1024
+#define TMR0_OPTION (0xD1)        // PSA assigned; PS 1:4
+#define TMR0_PRESCALE 4
+#elif DITHER_STEP_CYCLES <= 2048
+#define TMR0_OPTION (0xD2)        // PSA assigned; PS 1:8
+#define TMR0_PRESCALE 8
+#elif DITHER_STEP_CYCLES <= 4096
+#define TMR0_OPTION (0xD3)        // PSA assigned; PS 1:16
+#define TMR0_PRESCALE 16
+#elif DITHER_STEP_CYCLES <= 8192
+#define TMR0_OPTION (0xD4)        // PSA assigned; PS 1:32
+#define TMR0_PRESCALE 32
+#elif DITHER_STEP_CYCLES <= 16384
+#define TMR0_OPTION (0xD5)        // PSA assigned; PS 1:64
+#define TMR0_PRESCALE 64
+#elif DITHER_STEP_CYCLES <= 32768
+#define TMR0_OPTION (0xD6)        // PSA assigned; PS 1:128
+#define TMR0_PRESCALE 128
+#elif DITHER_STEP_CYCLES <= 65536
+#define TMR0_OPTION (0xD7)        // PSA assigned; PS 1:256
+#define TMR0_PRESCALE 256
+#else
+#error DITHER_STEPS * DITHER_FRAME_HZ is too low for TMR0
+#endif
+#if ((_XTAL_FREQ / 4UL) % (1UL * DITHER_STEPS * DITHER_FRAME_HZ)) || (DITHER_STEP_CYCLES % TMR0_PRESCALE)
+#error DITHER_STEPS * DITHER_FRAME_HZ must give each step a whole number of TMR0 counts
+#endif
+#define TMR0_RELOAD ((uint8_t)(256 - DITHER_STEP_CYCLES / TMR0_PRESCALE))
+#else
 //#define TMR0_RELOAD 0x87        // Each of LEDs serviced for 125uS every 1ms
+#define TMR0_OPTION (0xD1)        // PSA assigned; PS 1:4
 #define TMR0_RELOAD (0xE0)        // Each of LEDs serviced for 125uS every 1ms
+#endif
 
 void TMR0_Initialize(void)
 {
     // Set TMR0 to the options selected in the User Interface
 	
-    // PSA assigned; PS 1:4; TMRSE Increment_hi_lo; mask the nWPUEN and INTEDG bits
-    OPTION_REG = (uint8_t)(((OPTION_REG & 0xC0) | 0xD1) & 0x3F); 
+    // PSA assigned; PS per TMR0_OPTION; TMRSE Increment_hi_lo; mask the nWPUEN and INTEDG bits
+    OPTION_REG = (uint8_t)(((OPTION_REG & 0xC0) | TMR0_OPTION) & 0x3F); 
 	
     // TMR0 6; 
     TMR0 = TMR0_RELOAD;
@@ -106,12 +164,24 @@ void TMR0_Reload(void)
 }
 #endif
 
+void TMR0_SetReload(uint8_t reloadVal)
+{
+    // Loaded into TMR0 by the next TMR0_ISR
+    timer0ReloadVal = reloadVal;
+}
+
 void TMR0_ISR(void)
 {
 
     // Clear the TMR0 interrupt flag
     INTCONbits.TMR0IF = 0;
 
+#if PWM_ENGINE == PWM_ENGINE_BAM
+    // Reload a whole BAM unit after the overflow. The write clears the
+    // prescaler, so each slot is then exactly one unit longer than its
+    // reload, which RunTMR0 allows for.
+    _delay(BAM_UNIT_CYCLES - TMR0_RELOAD_LATENCY);
+#endif
     TMR0 = timer0ReloadVal;
 
     // ticker function call;
@@ -64,8 +64,12 @@
 */
 
 #define TMR0_INTERRUPT_TICKER_FACTOR    1
-      
-#define TMR0_TICKS_PER_MS              31
+
+// Instruction cycles from TMR0 overflowing to TMR0_ISR writing its reload:
+// the interrupt latency, INTERRUPT_InterruptManager's TMR0IE/TMR0IF tests, the
+// call to TMR0_ISR unless ISR_STATIC_DISPATCH does its work in place, and
+// clearing TMR0IF. The host simulator's cost model checks it agrees.
+#define TMR0_RELOAD_LATENCY             (ISR_STATIC_DISPATCH ? 15 : 18)
 
 /**
   Section: TMR0 APIs
@@ -210,6 +214,44 @@ void TMR0_WriteTimer(uint8_t timerVal);
 */
 void TMR0_Reload(void);
 
+/**
+  @Summary
+    Set the TMR0 reload value.
+
+  @Description
+    This function sets the value TMR0_ISR loads into TMR0 on every
+    following interrupt, which sets the length of the next period.
+    When called from the TMR0 interrupt handler it takes effect for the
+    period after the one that has just started.
+
+  @Preconditions
+    Initialize  the TMR0 before calling this function.
+
+  @Param
+    reloadVal - Value to load into TMR0. The period is (256 - reloadVal)
+    counts, so 0 gives the full 256.
+
+  @Returns
+    None
+
+  @Example
+    <code>
+    // Interrupt every 100 counts from the period after this one
+    TMR0_SetReload(256 - 100);
+    </code>
+*/
+void TMR0_SetReload(uint8_t reloadVal);
+
+/**
+  @Summary
+    Timer Reload Value
+
+  @Description
+    The value TMR0_ISR loads into TMR0, as set by TMR0_SetReload. Read
+    directly by INTERRUPT_InterruptManager when ISR_STATIC_DISPATCH is set.
+*/
+extern volatile uint8_t timer0ReloadVal;
+
 /**
   @Summary
     Timer Interrupt Service Routine
@@ -0,0 +1,101 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * LED pattern bytecode
+ *
+ * The LED shows are small programs that RunPattern steps through, kept as
+ * one const array in flash, PatternCode[]. They are written as text in
+ * pattern_shows.txt and compiled into pattern_shows.h by patc, from
+ * src/host (make -C src/host patterns). Don't edit pattern_shows.h by hand.
+ *
+ * Each instruction is one opcode byte followed by its operands. 16 bit
+ * operands are stored low byte first. A show runs its instructions in turn
+ * until one waits, picking up from there when that wait is over, and stops
+ * at PATTERN_END.
+ *
+ * PatternSpeed is the show's step time, in milliseconds. It starts at 0. To
+ * speed up or slow down, a show steps through a tempo curve, a list of step
+ * times patc works out ahead of time, so RunPattern only has to read the next
+ * one from flash.
+ *
+ * Most shows only use a few brightness levels, so patc gives each show a
+ * palette of up to 16 of them, and its frames are stored as 2 bit palette
+ * indexes if the palette has up to 4 levels, or 4 bit ones if it has more.
+ * D1's index is in the lowest bits. Only shows with more than 16 levels use
+ * PATTERN_SET_FRAME.
+ *
+ * After a PATTERN_FADE, frames are keyframes: rather than being shown at once,
+ * each one is faded to over the first wait after it. RunPatternFade moves the
+ * LEDs one step along the fade each millisecond using only adds and shifts, so
+ * a smooth show only has to store the frames it passes through.
+ *
+ * A generator instruction makes the frames itself, from the sine wave in
+ * PatternQuarterSine or a 16 bit LFSR, until the next frame or the end of the
+ * show. Its operands stay in flash, so it takes no RAM but its phases.
+ */
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+// Deepest nesting of PATTERN_LOOPs
+#define PATTERN_LOOP_DEPTH    2
+
+// Most levels a PATTERN_PALETTE can have
+#define PATTERN_PALETTE_SIZE  16
+
+// Longest fade, so that a linear fade's 16 bit DDA can add up to 255 levels
+// to its error without overflowing. A longer wait only fades for this long.
+#define PATTERN_FADE_MAX_MS   65280
+
+typedef enum
+{
+  PATTERN_END,                // turn every LED off and stop
+  PATTERN_SET_FRAME,          // 5 bytes: D1-D5 brightness. Shown from the
+                              // next PWM frame.
+  PATTERN_WAIT,               // wait PatternSpeed ms
+  PATTERN_WAIT_MS,            // 16 bits: wait this many ms
+  PATTERN_SET_SPEED,          // 16 bits: PatternSpeed
+  PATTERN_TEMPO,              // 1 byte: N, then N bytes: a tempo curve, the
+                              // step times for PATTERN_TEMPO_STEP to take in
+                              // turn
+  PATTERN_TEMPO_WIDE,         // the same, with 16 bit step times
+  PATTERN_LOOP,               // 1 byte: run up to the PATTERN_NEXT this many
+                              // times, or for ever if 0
+  PATTERN_NEXT,               // end of the innermost PATTERN_LOOP
+  PATTERN_TEMPO_STEP,         // 16 bits: where the innermost loop ends. Set
+                              // PatternSpeed to the tempo curve's next step
+                              // time, or once they're all used, leave the
+                              // loop.
+  PATTERN_PALETTE,            // 1 byte: N, 1 to PATTERN_PALETTE_SIZE, then N
+                              // bytes: the brightness of each index
+  PATTERN_FRAME_2BIT,         // 16 bits: D1-D5 palette indexes, 2 bits each
+  PATTERN_FRAME_4BIT,         // 3 bytes: D1-D5 palette indexes, 4 bits each
+  PATTERN_FADE,               // 1 byte: a PatternFade_t for the frames after it
+  PATTERN_WAVE,               // 16 bits: phase step per ms, a turn being
+                              // 65536, then 16 bits: how far each LED's phase
+                              // is behind the one before's, then 1 byte:
+                              // shift the sine right by this. Each LED
+                              // follows a sine wave.
+  PATTERN_SCAN,               // 16 bits: phase step per ms, then 1 byte:
+                              // shift right by this. A lit eye swings from
+                              // D1 to D5 and back along a sine wave.
+  PATTERN_FLICKER,            // 1 byte: ms between frames, 1 byte: lowest
+                              // level, 1 byte: ANDed with a random number
+                              // and added to it
+  PATTERN_SPARKLE,            // 1 byte: ms between frames, 1 byte: a random
+                              // number ANDed with this is 0 to flash an LED,
+                              // 1 byte: the flash's level. LEDs halve each
+                              // frame.
+  PATTERN_OP_COUNT
+} PatternOp_t;
+
+typedef enum
+{
+  PATTERN_FADE_OFF,           // show each frame at once
+  PATTERN_FADE_LINEAR,        // fade in a straight line
+  PATTERN_FADE_EASE,          // close a fixed share of what's left each ms,
+                              // so fast at first and settling gently
+  PATTERN_FADE_COUNT
+} PatternFade_t;
+
+#endif // PATTERN_H
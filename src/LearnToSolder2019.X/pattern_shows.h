@@ -0,0 +1,144 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * LED shows, compiled from pattern_shows.txt by patc. Don't edit: change
+ * pattern_shows.txt and run make -C src/host patterns.
+ */
+
+#ifndef PATTERN_SHOWS_H
+#define PATTERN_SHOWS_H
+
+#include <stdint.h>
+
+#include "pattern.h"
+
+#define PATTERN_SHOW_COUNT    6
+
+static const uint8_t PatternCode[296] = {
+  // chase
+  PATTERN_PALETTE, 3, 0, 1, 50,
+  PATTERN_TEMPO, 10, 120, 96, 76, 60, 48, 38, 30, 24, 19, 15,    // exp 150 8/10 15
+  PATTERN_LOOP, 0,
+  PATTERN_FRAME_2BIT, 2, 1,    // 50 0 0 0 1
+  PATTERN_TEMPO_STEP, 55, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 72, 0,    // 0 50 0 1 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 32, 0,    // 0 0 50 0 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 132, 0,    // 0 1 0 50 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 1, 2,    // 1 0 0 0 50
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 132, 0,    // 0 1 0 50 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 32, 0,    // 0 0 50 0 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 72, 0,    // 0 50 0 1 0
+  PATTERN_WAIT,
+  PATTERN_NEXT,
+  PATTERN_WAIT_MS, 1, 0,
+  PATTERN_LOOP, 3,
+  PATTERN_FRAME_2BIT, 34, 2,    // 50 0 50 0 50
+  PATTERN_WAIT_MS, 94, 1,
+  PATTERN_FRAME_2BIT, 136, 0,    // 0 50 0 50 0
+  PATTERN_WAIT_MS, 94, 1,
+  PATTERN_NEXT,
+  PATTERN_FRAME_2BIT, 34, 2,    // 50 0 50 0 50
+  PATTERN_WAIT_MS, 94, 1,
+  PATTERN_END,
+
+  // bounce
+  PATTERN_PALETTE, 3, 0, 8, 50,
+  PATTERN_TEMPO, 40, 40, 40, 40, 41, 42, 43, 44, 45, 47, 49, 51, 53, 55, 58, 61, 64, 67, 70, 74, 78, 82, 86, 91, 96, 101, 106, 111, 117, 122, 128, 135, 141, 148, 155, 162, 169, 176, 184, 192, 200,    // ease-in 40 200 40
+  PATTERN_LOOP, 5,
+  PATTERN_FRAME_2BIT, 6, 0,    // 50 8 0 0 0
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 25, 0,    // 8 50 8 0 0
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 100, 0,    // 0 8 50 8 0
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 144, 1,    // 0 0 8 50 8
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 64, 2,    // 0 0 0 8 50
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 144, 1,    // 0 0 8 50 8
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 100, 0,    // 0 8 50 8 0
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 25, 0,    // 8 50 8 0 0
+  PATTERN_TEMPO_STEP, 186, 0,
+  PATTERN_WAIT,
+  PATTERN_NEXT,
+  PATTERN_FRAME_2BIT, 6, 0,    // 50 8 0 0 0
+  PATTERN_WAIT,
+  PATTERN_END,
+
+  // breathe
+  PATTERN_PALETTE, 2, 0, 50,
+  PATTERN_FADE, 1,    // linear
+  PATTERN_LOOP, 3,
+  PATTERN_FRAME_2BIT, 85, 1,    // 50 50 50 50 50
+  PATTERN_WAIT_MS, 184, 1,
+  PATTERN_WAIT_MS, 200, 0,
+  PATTERN_FRAME_2BIT, 0, 0,    // 0 0 0 0 0
+  PATTERN_WAIT_MS, 184, 1,
+  PATTERN_WAIT_MS, 44, 1,
+  PATTERN_NEXT,
+  PATTERN_END,
+
+  // ripple
+  PATTERN_PALETTE, 3, 0, 12, 50,
+  PATTERN_FADE, 2,    // ease
+  PATTERN_SET_SPEED, 160, 0,
+  PATTERN_LOOP, 4,
+  PATTERN_FRAME_2BIT, 32, 0,    // 0 0 50 0 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 152, 0,    // 0 50 12 50 0
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 70, 2,    // 50 12 0 12 50
+  PATTERN_WAIT,
+  PATTERN_FRAME_2BIT, 1, 1,    // 12 0 0 0 12
+  PATTERN_WAIT,
+  PATTERN_NEXT,
+  PATTERN_FRAME_2BIT, 0, 0,    // 0 0 0 0 0
+  PATTERN_WAIT,
+  PATTERN_END,
+
+  // scanner
+  PATTERN_PALETTE, 1, 0,
+  PATTERN_SCAN, 55, 0, 2,    // scan 1200 2
+  PATTERN_WAIT_MS, 112, 23,
+  PATTERN_WAVE, 44, 0, 51, 51, 2,    // wave 1500 72 2
+  PATTERN_WAIT_MS, 112, 23,
+  PATTERN_FADE, 1,    // linear
+  PATTERN_FRAME_2BIT, 0, 0,    // 0 0 0 0 0
+  PATTERN_WAIT_MS, 44, 1,
+  PATTERN_END,
+
+  // candle
+  PATTERN_FLICKER, 40, 8, 15,    // flicker 40 8 16
+  PATTERN_WAIT_MS, 112, 23,
+  PATTERN_SPARKLE, 30, 3, 50,    // sparkle 30 4 50
+  PATTERN_WAIT_MS, 136, 19,
+  PATTERN_END,
+};
+
+// Where each show starts in PatternCode
+static const uint16_t PatternShows[PATTERN_SHOW_COUNT] = {
+  0,    // chase
+  80,    // bounce
+  191,    // breathe
+  219,    // ripple
+  253,    // scanner
+  281,    // candle
+};
+
+#endif // PATTERN_SHOWS_H
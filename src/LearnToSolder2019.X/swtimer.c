@@ -0,0 +1,183 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Software timers. See swtimer.h.
+ */
+
+#include "mcc_generated_files/mcc.h"
+#include "swtimer.h"
+#include "events.h"
+#include "atomic.h"
+
+// End of the list of running timers
+#define TIMER_NONE            0xFF
+
+// The running timer that expires first, or TIMER_NONE
+static uint8_t TimerHead = TIMER_NONE;
+
+// Milliseconds until TimerHead expires, or 0 if no timer is running. This is
+// the only thing RunTimers counts down.
+static volatile uint16_t TimerCountdown;
+
+// For each running timer, the one that expires after it, and for all but
+// TimerHead, how many milliseconds after the one before it it expires
+static uint8_t TimerNext[TIMER_COUNT];
+static uint16_t TimerDelta[TIMER_COUNT];
+
+static volatile bool TimerRunning[TIMER_COUNT];
+
+#if TIMER_CALLBACKS
+static void (*TimerCallback[TIMER_COUNT])(void);
+#endif
+
+// Take a running timer out of the list. Interrupts must be off.
+static void UnlinkTimer(uint8_t Timer)
+{
+  uint8_t Prev;
+  uint8_t Next = TimerNext[Timer];
+
+  if (TimerHead == Timer)
+  {
+    // The next timer was due TimerDelta[Next] after this one
+    TimerHead = Next;
+    TimerCountdown = (Next == TIMER_NONE) ? 0 : (uint16_t)(TimerCountdown + TimerDelta[Next]);
+  }
+  else
+  {
+    Prev = TimerHead;
+    while (TimerNext[Prev] != Timer)
+    {
+      Prev = TimerNext[Prev];
+    }
+    TimerNext[Prev] = Next;
+    if (Next != TIMER_NONE)
+    {
+      TimerDelta[Next] += TimerDelta[Timer];
+    }
+  }
+  TimerRunning[Timer] = false;
+}
+
+// Put a timer into the list, due Ms (at least 1) milliseconds from now.
+// Interrupts must be off.
+static void LinkTimer(uint8_t Timer, uint16_t Ms)
+{
+  uint8_t Prev = TIMER_NONE;
+  uint8_t Next = TimerHead;
+  uint16_t Gap = TimerCountdown;
+
+  // Go past every timer due by then, so that timers due together expire in
+  // the order they were started. Ms ends up relative to Prev.
+  while ((Next != TIMER_NONE) && (Ms >= Gap))
+  {
+    Ms -= Gap;
+    Prev = Next;
+    Next = TimerNext[Next];
+    if (Next != TIMER_NONE)
+    {
+      Gap = TimerDelta[Next];
+    }
+  }
+
+  TimerNext[Timer] = Next;
+  if (Next != TIMER_NONE)
+  {
+    TimerDelta[Next] = Gap - Ms;
+  }
+  if (Prev == TIMER_NONE)
+  {
+    TimerHead = Timer;
+    TimerCountdown = Ms;
+  }
+  else
+  {
+    TimerNext[Prev] = Timer;
+    TimerDelta[Timer] = Ms;
+  }
+  TimerRunning[Timer] = true;
+}
+
+void StartTimer(Timer_t Timer, uint16_t Ms)
+{
+  bool InterruptsOn = AtomicBegin();
+
+  if (TimerRunning[Timer])
+  {
+    UnlinkTimer(Timer);
+  }
+  if (Ms)
+  {
+    LinkTimer(Timer, Ms);
+  }
+  AtomicEnd(InterruptsOn);
+}
+
+void StopTimer(Timer_t Timer)
+{
+  bool InterruptsOn = AtomicBegin();
+
+  if (TimerRunning[Timer])
+  {
+    UnlinkTimer(Timer);
+  }
+  AtomicEnd(InterruptsOn);
+}
+
+bool TimerExpired(Timer_t Timer)
+{
+  return !TimerRunning[Timer];
+}
+
+uint16_t TimeToNextTimer(void)
+{
+  return TimerCountdown;
+}
+
+void AdvanceTimers(uint32_t Ms)
+{
+  if (TimerCountdown == 0)
+  {
+    return;
+  }
+  if (Ms >= TimerCountdown)
+  {
+    Ms = TimerCountdown - 1U;
+  }
+  TimerCountdown -= (uint16_t)Ms;
+}
+
+#if TIMER_CALLBACKS
+void SetTimerCallback(Timer_t Timer, void (* Callback)(void))
+{
+  bool InterruptsOn = AtomicBegin();
+
+  TimerCallback[Timer] = Callback;
+  AtomicEnd(InterruptsOn);
+}
+#endif
+
+void RunTimers(void)
+{
+  uint8_t Timer;
+
+  if ((TimerCountdown == 0) || --TimerCountdown)
+  {
+    return;
+  }
+
+  // Expire the first timer, and every one due at the same time as it
+  do
+  {
+    Timer = TimerHead;
+    TimerHead = TimerNext[Timer];
+    TimerCountdown = (TimerHead == TIMER_NONE) ? 0 : TimerDelta[TimerHead];
+    TimerRunning[Timer] = false;
+    PostEvent(EVENT_TIMER_EXPIRED, Timer);
+#if TIMER_CALLBACKS
+    if (TimerCallback[Timer])
+    {
+      TimerCallback[Timer]();
+    }
+#endif
+  } while ((TimerHead != TIMER_NONE) && (TimerCountdown == 0));
+}
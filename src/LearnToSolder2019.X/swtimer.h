@@ -0,0 +1,64 @@
+/*
+ * Learn To Solder 2019 board software
+ *
+ * Software timers
+ *
+ * A fixed pool of millisecond timers, one for each Timer_t. Running timers are
+ * kept in a list ordered by when they expire, each one holding only the time
+ * from the one before it, so the ISR counts down just the first of them each
+ * millisecond no matter how many are running.
+ *
+ * StartTimer, StopTimer and SetTimerCallback are for mainline. A timer callback
+ * can call them too, but XC8 then keeps a second copy of each for the
+ * interrupt, as it does for any function both call. The ISR's own timer work
+ * is all in RunTimers. TimerExpired reads a single byte, so mainline can
+ * poll it at any time. Each expiry is also posted as an EVENT_TIMER_EXPIRED
+ * (events.h), so mainline can wait for the next one instead of polling every
+ * timer.
+ */
+
+#ifndef SWTIMER_H
+#define SWTIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "app_config.h"
+
+typedef enum
+{
+  TIMER_DEBOUNCE,             // button debounce
+  TIMER_SHUTDOWN_DELAY,       // last look at the button before sleeping
+  TIMER_PATTERN_STEP,         // time to the next step of the LED pattern
+  TIMER_PATTERN_TICK,         // next update of an LED pattern fade or generator
+  TIMER_COUNT
+} Timer_t;
+
+// (Re)start Timer to expire Ms milliseconds from now. 0 expires it at once.
+void StartTimer(Timer_t Timer, uint16_t Ms);
+
+// Stop Timer without running its callback. It then reads as expired.
+void StopTimer(Timer_t Timer);
+
+// True once Timer has expired or been stopped, and before it is first started
+bool TimerExpired(Timer_t Timer);
+
+// Milliseconds until the next timer expires, or 0 if none is running.
+// Interrupts must be off.
+uint16_t TimeToNextTimer(void);
+
+// Count Ms milliseconds at once, for time the 1ms tick did not see, such as
+// time spent asleep. Only counts up to a millisecond before the next expiry,
+// leaving the tick to expire it, so that timers only expire in the ISR.
+// Interrupts must be off.
+void AdvanceTimers(uint32_t Ms);
+
+#if TIMER_CALLBACKS
+// Have the ISR call Callback when Timer expires, or nothing if it is NULL
+void SetTimerCallback(Timer_t Timer, void (* Callback)(void));
+#endif
+
+// Count one millisecond and expire any timers that are due. ISR only.
+void RunTimers(void);
+
+#endif // SWTIMER_H
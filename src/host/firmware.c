@@ -0,0 +1,707 @@
+/*
+ * Learn To Solder 2019 host simulator
+ *
+ * main.c, swtimer.c, debounce.c, events.c and atomic.c are compiled here,
+ * as part of this translation unit, so the probes below can reach their
+ * static variables. See firmware.h. The stress build compiles atomic.c on
+ * its own, outside the instrumentation (see stress.h).
+ */
+
+#include "../LearnToSolder2019.X/main.c"
+#include "../LearnToSolder2019.X/swtimer.c"
+#include "../LearnToSolder2019.X/debounce.c"
+#include "../LearnToSolder2019.X/events.c"
+#ifndef SIM_STRESS
+#include "../LearnToSolder2019.X/atomic.c"
+#endif
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "firmware.h"
+
+#define FW_STABLE(State, Var)                                                 \
+  do {                                                                        \
+    if ((State)->StableSize + sizeof(Var) > FW_MAX_STABLE_BYTES)              \
+    {                                                                         \
+      abort();                                                                \
+    }                                                                         \
+    memcpy(&(State)->Stable[(State)->StableSize], (const void *)&(Var),      \
+           sizeof(Var));                                                      \
+    (State)->StableSize += sizeof(Var);                                       \
+  } while (0)
+
+/*
+  Interrupt cost model
+
+  Instruction cycles for each piece of the interrupt path, counted by hand from
+  the code XC8 2.05 generates in free mode (-O0) for the PIC12F1572, including
+  the bank selects. The enhanced mid-range core saves context in hardware, so
+  entry is just the 3-5 cycle latency. costs.md5 holds checksums of the
+  sources they were counted from, and make fails until they are counted again
+  after any of those sources changes (see the Makefile).
+*/
+#define COST_ENTRY                  4   // latency and vector
+#define COST_EXIT                   2   // RETFIE
+#define COST_TEST_TMR0              6   // TMR0IE/TMR0IF tests
+#define COST_TEST_IOC               5   // IOCIE/IOCIF tests
+#define COST_TEST_TMR2              6   // PEIE/TMR2IE/TMR2IF tests
+#define COST_TEST_NONE              1   // fall out of the last test
+#if ISR_STATIC_DISPATCH
+#define COST_CALL_ISR               0   // the source's ISR is done in place
+#define COST_HANDLER_CALL           3   // page select and call to a bound handler
+#define COST_TMR2_ISR               1   // clear TMR2IF
+#define COST_IOC_TEST               4   // IOCAF2 and IOCAF3 tests
+#define COST_IOC_PIN                2   // clear IOCAFx
+#else
+#define COST_CALL_ISR               3   // call TMR0_ISR, PIN_MANAGER_IOC or TMR2_ISR
+#define COST_TMR0_ISR_CALL          6   // call TMR0_CallBack and return
+#define COST_TMR2_ISR               7   // clear TMR2IF, call TMR2_CallBack and return
+#define COST_IOC_TEST               8   // IOCAF2 and IOCAF3 tests, return
+#define COST_IOC_PIN               22   // IOCAFx_ISR: indirect call to the handler, clear flag
+#endif
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+#define COST_BUTTON_EDGE           16   // ButtonChanged stamps WakeTimer and RA3, ButtonSettling test
+#define COST_BUTTON_SETTLE          2   // set ButtonSettling
+#else
+#define COST_BUTTON_EDGE           14   // ButtonChanged: InputChanged, test what it returns
+#define COST_BUTTON_POST            6   // read RA3 for the EVENT_BUTTON_EDGE
+#define COST_DEBOUNCE_TICK          9   // call DebounceInputs, DebounceCountdown test, return
+#define COST_DEBOUNCE_SAMPLE       35   // read PORTA and TRISA, count, flip, record edges, DebounceBusy
+#endif
+#define COST_EVENT_POST            30   // call PostEvent, full test, store the slot, EventHead
+#define COST_TMR0_ISR_RELOAD        5   // clear TMR0IF, reload TMR0
+#define COST_CALLBACK              14   // null test, indirect call, return
+
+#define COST_FRAME_TAKE             8   // call TakeLEDFrame, LEDFrameCommitted test, return
+#define COST_FRAME_SWAP            14   // swap LEDFront and LEDBrightness, clear LEDFrameCommitted,
+                                        // LEDFrameDoneWanted test
+#define COST_HW_PWM_LOAD           84   // LoadHardwarePWM: three duty cycle sets and buffer loads
+#define COST_HW_PWM_STAGGER       174   // three phase calculations and phase sets
+#define COST_MS_TASKS              14   // call RunOneMSTasks, WakeTimer++, return
+#define COST_TIMERS                10   // call RunTimers, TimerCountdown test, return
+#define COST_TIMERS_DEC             5   // decrement TimerCountdown and test it
+#define COST_TIMERS_EXPIRE         22   // expire one timer and load the next countdown
+
+#if PWM_ENGINE == PWM_ENGINE_EDGE
+#define COST_RUNTMR0_BASE          26   // LATA from table, next edge, TMR0_SetReload
+#define COST_BUILD_BASE            40   // call, edge 0, last span, PWMEdgeCount, return
+#if LED_STAGGER
+#define COST_BUILD_LED             26   // read one LEDBrightness, record its start
+#define COST_BUILD_INSERT          34   // call InsertPWMStep, store the step, return
+#define COST_BUILD_SCAN            12   // check one existing step for a repeat
+#define COST_BUILD_SORT_SHIFT      20   // move one sorted step up
+#define COST_BUILD_EDGE            30   // one edge's LATA and span
+#define COST_BUILD_EDGE_LED        18   // test whether one LED covers an edge
+#else
+#define COST_BUILD_SORT_LED        24   // read one LEDBrightness and insert it
+#define COST_BUILD_SORT_SHIFT      20   // move one sorted entry up
+#define COST_BUILD_WALK_LED        18   // compare one sorted level and clear its bit
+#define COST_BUILD_EDGE            24   // start a new edge
+#endif
+#elif PWM_ENGINE == PWM_ENGINE_BAM
+#define COST_RUNTMR0_BASE          26   // BAMSlot test, LATA copy, next slot, TMR0_SetReload
+#define COST_RUNTMR0_INLINE        (2 * BAM_WRITE_CYCLES)   // bit 0 and 1 LATA writes; the sim times the _delay()s
+#define COST_BUILD_BASE            60   // call, clear BAMBitLATA[], return
+#define COST_BUILD_LED             12   // read one LEDBrightness
+#define COST_BUILD_BIT             11   // test and shift one bit
+#define COST_BUILD_BIT_SET          9   // OR one LED into BAMBitLATA[]
+#elif PWM_ENGINE == PWM_ENGINE_DITHER
+#define COST_RUNTMR0_BASE          26   // DitherStep test, LATA copy, next step
+#define COST_RUNTMR0_LED           24   // one LED's start and stop tests
+#define COST_RUNTMR0_LED_ON         6   // set one LATALEDs bit from LEDBits[]
+#define COST_RUNTMR0_LED_OFF        7   // clear one LATALEDs bit from LEDBits[]
+#define COST_BUILD_BASE            20   // call, clear LATALEDs, return
+#define COST_BUILD_LED            112   // scale one brightness, carry its error, start and stop
+#else
+#define COST_RUNTMR0_BASE          16   // PWMCounter test, LATA copy, PWMCounter++, return
+#if LED_STAGGER
+#define COST_RUNTMR0_FRAME         14   // first LED from LEDBits[], clear Start, loop set up
+#define COST_RUNTMR0_FRAME_LED     34   // one LED's stop step and wrap test
+#define COST_RUNTMR0_COMPARE        7   // one LEDStopShadow[] == PWMCounter test
+#define COST_RUNTMR0_HANDOVER       6   // turn one LED off and the next one on
+#define COST_RUNTMR0_LED_OFF        2   // turn the last LED off
+#else
+#define COST_RUNTMR0_FRAME          4   // LATALEDs = 0xFF
+#define COST_RUNTMR0_COMPARE       10   // one LEDFront[] == PWMCounter test, through FSR1
+#define COST_RUNTMR0_LED_OFF        2   // clear one LATALEDs bit
+#endif
+#endif
+
+static struct
+{
+  bool Tmr0;
+  bool Tmr2;
+  uint8_t IOCFlags;
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+  bool ButtonSettling;
+#else
+  uint8_t DebounceCountdown;
+  uint8_t DebouncedDown;
+  bool DebounceBusy;
+#endif
+  uint32_t WakeTimer;
+  uint16_t TimerCountdown;
+  bool TimerRunning[TIMER_COUNT];
+  bool Committed;
+  bool DoneWanted;
+  uint8_t Brightness[5];
+#if PWM_ENGINE == PWM_ENGINE_DITHER
+  uint8_t DitherStep;
+#endif
+#if PWM_ENGINE == PWM_ENGINE_COUNTER
+  uint8_t PWMCounter;
+#if LED_STAGGER
+  uint8_t Stop[5];
+#endif
+#endif
+} Model;
+
+void FW_BeforeInterrupt(void)
+{
+  Model.Tmr0 = INTCONbits.TMR0IE && INTCONbits.TMR0IF;
+  Model.Tmr2 = INTCONbits.PEIE && PIE1bits.TMR2IE && PIR1bits.TMR2IF;
+  Model.IOCFlags = (INTCONbits.IOCIE && INTCONbits.IOCIF) ? (IOCAF & 0x0C) : 0;
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+  Model.ButtonSettling = ButtonSettling;
+#else
+  Model.DebounceCountdown = DebounceCountdown;
+  Model.DebouncedDown = DebouncedDown;
+  Model.DebounceBusy = DebounceBusy;
+#endif
+  Model.WakeTimer = WakeTimer;
+  Model.TimerCountdown = TimerCountdown;
+  memcpy(Model.TimerRunning, (const void *)TimerRunning, sizeof(Model.TimerRunning));
+#if PWM_ENGINE == PWM_ENGINE_DITHER
+  Model.DitherStep = DitherStep;
+#elif PWM_ENGINE == PWM_ENGINE_COUNTER
+  Model.PWMCounter = PWMCounter;
+#endif
+  // A frame build shows the committed frame if there is one, or else the
+  // front frame again
+  Model.Committed = LEDFrameCommitted;
+  Model.DoneWanted = LEDFrameDoneWanted;
+#if PWM_ENGINE == PWM_ENGINE_COUNTER
+  if (Model.Tmr0 && (Model.PWMCounter == 0))
+#endif
+  {
+    memcpy(Model.Brightness, (const void *)(Model.Committed ? LEDBrightness : LEDFront),
+           sizeof(Model.Brightness));
+  }
+}
+
+_Static_assert(COST_ENTRY + COST_TEST_TMR0 + COST_CALL_ISR + COST_TMR0_ISR_RELOAD ==
+               TMR0_RELOAD_LATENCY, "TMR0_RELOAD_LATENCY in tmr0.h is out of step");
+
+uint32_t FW_ReloadLatencyCycles(void)
+{
+  return COST_ENTRY + COST_TEST_TMR0 + COST_CALL_ISR + COST_TMR0_ISR_RELOAD;
+}
+
+// Cost of TakeLEDFrame and LoadHardwarePWM at the start of a frame
+static uint32_t FrameStartCycles(void)
+{
+  uint32_t Cycles = COST_FRAME_TAKE;
+
+  if (Model.Committed)
+  {
+    Cycles += COST_FRAME_SWAP + (Model.DoneWanted ? COST_EVENT_POST : 0) +
+              (LED_FRAME_HANDLER ? COST_CALLBACK : 0);
+  }
+  return Cycles + (LED_HW_PWM ? (COST_HW_PWM_LOAD + (LED_STAGGER ? COST_HW_PWM_STAGGER : 0)) : 0);
+}
+
+// Number of times a countdown timer that started at Start was decremented
+// over Ms milliseconds
+static uint32_t Decrements(uint32_t Start, uint32_t Ms)
+{
+  return (Start < Ms) ? Start : Ms;
+}
+
+// Cost of the RunOneMSTasks calls made during this interrupt
+static uint32_t OneMSTaskCycles(void)
+{
+  uint32_t Ms = WakeTimer - Model.WakeTimer;
+  uint32_t Expired = 0;
+
+  for (uint8_t i = 0; i < TIMER_COUNT; i++)
+  {
+    Expired += Model.TimerRunning[i] && !TimerRunning[i];
+  }
+  uint32_t Cycles = Ms * (COST_MS_TASKS + COST_TIMERS) +
+                    Decrements(Model.TimerCountdown, Ms) * COST_TIMERS_DEC +
+                    Expired * (COST_TIMERS_EXPIRE + COST_EVENT_POST +
+                               (TIMER_CALLBACKS ? COST_CALLBACK : 0));
+
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_VERTICAL
+  // DebounceInputs samples on each tick that runs DebounceCountdown out
+  Cycles += Ms * COST_DEBOUNCE_TICK;
+  if (Ms >= Model.DebounceCountdown)
+  {
+    Cycles += (1 + (Ms - Model.DebounceCountdown) / DEBOUNCE_SAMPLE_MS) * COST_DEBOUNCE_SAMPLE;
+  }
+  // and posts an EVENT_INPUTS_CHANGED for any that flips
+  Cycles += (DebouncedDown != Model.DebouncedDown) ? COST_EVENT_POST : 0;
+#endif
+  return Cycles;
+}
+
+#if PWM_ENGINE == PWM_ENGINE_EDGE
+#if LED_STAGGER
+// Cost of InsertPWMStep adding Step to Steps[]. Returns the new count.
+static uint8_t InsertPWMStepCycles(uint8_t *Steps, uint8_t Count, uint8_t Step, uint32_t *Cycles)
+{
+  int j;
+
+  *Cycles += COST_BUILD_INSERT;
+  for (j = 0; j < Count; j++)
+  {
+    *Cycles += COST_BUILD_SCAN;
+    if (Steps[j] == Step)
+    {
+      return Count;
+    }
+  }
+  for (j = Count; (j > 0) && (Steps[j - 1] > Step); j--)
+  {
+    Steps[j] = Steps[j - 1];
+    *Cycles += COST_BUILD_SORT_SHIFT;
+  }
+  Steps[j] = Step;
+  return Count + 1;
+}
+
+// Cost of BuildPWMFrame for the brightness values it read
+static uint32_t BuildPWMFrameCycles(void)
+{
+  uint32_t Cycles = COST_BUILD_BASE + LED_SOFTWARE_COUNT * COST_BUILD_LED;
+  uint8_t Steps[PWM_EDGES_MAX] = {0};
+  uint8_t Count = 1;
+  uint8_t Step = 0;
+  uint8_t Level;
+
+  for (int i = 0; i < LED_SOFTWARE_COUNT; i++)
+  {
+    Level = Model.Brightness[LED_FIRST_SOFTWARE + i];
+    if (Level)
+    {
+      Count = InsertPWMStepCycles(Steps, Count, Step, &Cycles);
+      Step += Level;
+      Count = InsertPWMStepCycles(Steps, Count, Step, &Cycles);
+    }
+  }
+  Cycles += FrameStartCycles();
+  return Cycles + Count * (COST_BUILD_EDGE + LED_SOFTWARE_COUNT * COST_BUILD_EDGE_LED);
+}
+#else
+// Cost of BuildPWMFrame for the brightness values it read
+static uint32_t BuildPWMFrameCycles(void)
+{
+  uint32_t Cycles = COST_BUILD_BASE + LED_SOFTWARE_COUNT * (COST_BUILD_SORT_LED + COST_BUILD_WALK_LED);
+  uint8_t Level[5];
+  uint8_t Step;
+  int i;
+  int j;
+
+  for (i = 0; i < LED_SOFTWARE_COUNT; i++)
+  {
+    Step = Model.Brightness[LED_FIRST_SOFTWARE + i];
+    for (j = i; (j > 0) && (Level[j - 1] > Step); j--)
+    {
+      Level[j] = Level[j - 1];
+      Cycles += COST_BUILD_SORT_SHIFT;
+    }
+    Level[j] = Step;
+  }
+  Cycles += FrameStartCycles();
+  return Cycles + (PWMEdgeCount - 1) * COST_BUILD_EDGE;
+}
+#endif
+
+// Cost of RunTMR0 for the edge it has just output
+static uint32_t RunTMR0Cycles(void)
+{
+  uint32_t Cycles = COST_RUNTMR0_BASE;
+
+  if (PWMEdge == 0)
+  {
+    Cycles += BuildPWMFrameCycles();
+  }
+  return Cycles;
+}
+#elif PWM_ENGINE == PWM_ENGINE_BAM
+// Cost of BuildBAMFrame for the brightness values it read
+static uint32_t BuildBAMFrameCycles(void)
+{
+  uint32_t Cycles = COST_BUILD_BASE + LED_SOFTWARE_COUNT * (COST_BUILD_LED + 8 * COST_BUILD_BIT);
+
+  for (int i = LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    Cycles += __builtin_popcount(Model.Brightness[i]) * COST_BUILD_BIT_SET;
+  }
+  return Cycles + FrameStartCycles();
+}
+
+// Cost of RunTMR0 for the slot it has just started, apart from its delays
+static uint32_t RunTMR0Cycles(void)
+{
+  uint32_t Cycles = COST_RUNTMR0_BASE;
+
+  if (BAMSlot == 1)
+  {
+    Cycles += COST_RUNTMR0_INLINE;
+  }
+  if (BAMSlot == 0)
+  {
+    Cycles += BuildBAMFrameCycles();
+  }
+  return Cycles;
+}
+#elif PWM_ENGINE == PWM_ENGINE_DITHER
+// Cost of RunTMR0 for the step it has just output
+static uint32_t RunTMR0Cycles(void)
+{
+  uint32_t Cycles = COST_RUNTMR0_BASE + LED_SOFTWARE_COUNT * COST_RUNTMR0_LED;
+
+  if (Model.DitherStep == 0)
+  {
+    Cycles += COST_BUILD_BASE + LED_SOFTWARE_COUNT * COST_BUILD_LED + FrameStartCycles();
+  }
+  for (int i = LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    Cycles += (DitherStart[i] == Model.DitherStep) ? COST_RUNTMR0_LED_ON : 0;
+    Cycles += (DitherStop[i] == Model.DitherStep) ? COST_RUNTMR0_LED_OFF : 0;
+  }
+  return Cycles;
+}
+#else
+#if LED_STAGGER
+// Cost of RunTMR0 for the tick the model is on
+static uint32_t RunTMR0Cycles(void)
+{
+  uint32_t Cycles = COST_RUNTMR0_BASE + LED_SOFTWARE_COUNT * COST_RUNTMR0_COMPARE;
+  uint8_t Stop = 0;
+  int i;
+
+  if (Model.PWMCounter == 0)
+  {
+    Cycles += COST_RUNTMR0_FRAME + LED_SOFTWARE_COUNT * COST_RUNTMR0_FRAME_LED +
+              FrameStartCycles();
+    for (i = LED_FIRST_SOFTWARE; i < 5; i++)
+    {
+      Stop += Model.Brightness[i];
+      Model.Stop[i] = Stop;
+    }
+  }
+  for (i = LED_FIRST_SOFTWARE; i < 5; i++)
+  {
+    if (Model.Stop[i] == Model.PWMCounter)
+    {
+      Cycles += (i < 4) ? COST_RUNTMR0_HANDOVER : COST_RUNTMR0_LED_OFF;
+    }
+  }
+  return Cycles;
+}
+#else
+// Cost of RunTMR0 for the tick the model is on
+static uint32_t RunTMR0Cycles(void)
+{
+  uint32_t Cycles = COST_RUNTMR0_BASE + 5 * COST_RUNTMR0_COMPARE;
+
+  if (Model.PWMCounter == 0)
+  {
+    Cycles += COST_RUNTMR0_FRAME + FrameStartCycles();
+  }
+  for (int i = 0; i < 5; i++)
+  {
+    if (Model.Brightness[i] == Model.PWMCounter)
+    {
+      Cycles += COST_RUNTMR0_LED_OFF;
+    }
+  }
+  return Cycles;
+}
+#endif
+#endif
+
+// Part of the last FW_InterruptCycles that went on getting from the vector to
+// the handlers and back, and how far into it each source was serviced
+static uint32_t DispatchCycles;
+static uint32_t ServiceCycles[FW_SOURCE_COUNT];
+
+// TMR0_ISR and RunTMR0, adding the time spent in RunTMR0 to *Handler
+static uint32_t Tmr0Cycles(uint32_t *Handler)
+{
+#if ISR_STATIC_DISPATCH
+  *Handler += RunTMR0Cycles();
+  return COST_TMR0_ISR_RELOAD + COST_HANDLER_CALL;
+#else
+  *Handler += TMR0_InterruptHandler ? RunTMR0Cycles() : 0;
+  return COST_TMR0_ISR_RELOAD + COST_TMR0_ISR_CALL + COST_CALLBACK;
+#endif
+}
+
+// PIN_MANAGER_IOC and the IOCAFx_ISRs
+static uint32_t IocCycles(void)
+{
+  uint32_t Cycles = COST_IOC_TEST;
+
+  Cycles += (Model.IOCFlags & 0x04) ? COST_IOC_PIN : 0;
+  if (Model.IOCFlags & 0x08)
+  {
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+    Cycles += COST_IOC_PIN + COST_BUTTON_EDGE +
+              (Model.ButtonSettling ? 0 : COST_BUTTON_SETTLE + COST_EVENT_POST);
+#else
+    Cycles += COST_IOC_PIN + COST_BUTTON_EDGE +
+              (Model.DebounceBusy ? 0 : COST_BUTTON_POST + COST_EVENT_POST);
+#endif
+  }
+#if ISR_STATIC_DISPATCH && defined(ISR_IOCAF2_HANDLER)
+  Cycles += (Model.IOCFlags & 0x04) ? COST_HANDLER_CALL : 0;
+#endif
+#if ISR_STATIC_DISPATCH && defined(ISR_IOCAF3_HANDLER)
+  Cycles += (Model.IOCFlags & 0x08) ? COST_HANDLER_CALL : 0;
+#endif
+  return Cycles;
+}
+
+// TMR2_ISR and RunOneMSTasks, adding the time spent in RunOneMSTasks to *Handler
+static uint32_t Tmr2Cycles(uint32_t *Handler)
+{
+#if ISR_STATIC_DISPATCH
+  // OneMSTaskCycles counts the call to RunOneMSTasks
+  *Handler += OneMSTaskCycles();
+  return COST_TMR2_ISR;
+#else
+  *Handler += TMR2_InterruptHandler ? OneMSTaskCycles() : 0;
+  return COST_TMR2_ISR + COST_CALLBACK;
+#endif
+}
+
+uint32_t FW_InterruptCycles(void)
+{
+  uint32_t Cycles = COST_ENTRY + COST_TEST_TMR0;
+  uint32_t HandlerCycles = 0;
+  bool Serviced = false;
+
+  memset(ServiceCycles, 0, sizeof(ServiceCycles));
+
+  // Handler time is added as it passes, so each source's service point
+  // includes the handlers that ran before it
+  if (Model.Tmr0)
+  {
+    ServiceCycles[FW_SOURCE_TMR0] = Cycles + HandlerCycles + COST_CALL_ISR;
+    Cycles += COST_CALL_ISR + Tmr0Cycles(&HandlerCycles);
+    Serviced = true;
+  }
+  if (!Serviced || ISR_SERVICE_ALL)
+  {
+    Cycles += COST_TEST_IOC;
+    if (Model.IOCFlags)
+    {
+      ServiceCycles[FW_SOURCE_IOC] = Cycles + HandlerCycles + COST_CALL_ISR;
+      Cycles += COST_CALL_ISR + IocCycles();
+      Serviced = true;
+    }
+  }
+  if (!Serviced || ISR_SERVICE_ALL)
+  {
+    Cycles += COST_TEST_TMR2;
+    if (Model.Tmr2)
+    {
+      ServiceCycles[FW_SOURCE_TMR2] = Cycles + HandlerCycles + COST_CALL_ISR;
+      Cycles += COST_CALL_ISR + Tmr2Cycles(&HandlerCycles);
+      Serviced = true;
+    }
+  }
+  if (!Serviced)
+  {
+    Cycles += COST_TEST_NONE;
+  }
+  Cycles += COST_EXIT;
+  DispatchCycles = Cycles;
+  return Cycles + HandlerCycles;
+}
+
+uint32_t FW_DispatchCycles(void)
+{
+  return DispatchCycles;
+}
+
+uint32_t FW_ServiceCycles(int Source)
+{
+  return ServiceCycles[Source];
+}
+
+uint32_t FW_WakeTimer(void)
+{
+  return WakeTimer;
+}
+
+void FW_GetState(FwState_t *State)
+{
+  memset(State, 0, sizeof(*State));
+  State->WakeTimer = WakeTimer;
+
+  // The other running timers are held relative to the first one
+  State->Timers[State->TimerCount++] = TimerCountdown;
+
+  FW_STABLE(State, LEDFrames);
+  FW_STABLE(State, LEDBrightness);
+  FW_STABLE(State, LEDFront);
+  FW_STABLE(State, LEDFrameCommitted);
+  FW_STABLE(State, LEDFrameDoneWanted);
+  FW_STABLE(State, ButtonState);
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+  FW_STABLE(State, ButtonEdgeTime);
+  FW_STABLE(State, ButtonEdgePressed);
+  FW_STABLE(State, ButtonSettling);
+#else
+  FW_STABLE(State, DebounceCountdown);
+  FW_STABLE(State, DebouncedDown);
+  FW_STABLE(State, DebounceCount0);
+  FW_STABLE(State, DebounceCount1);
+  FW_STABLE(State, InputPresses);
+  FW_STABLE(State, InputReleases);
+  FW_STABLE(State, DebounceBusy);
+#endif
+  FW_STABLE(State, PatternRunning);
+  FW_STABLE(State, PatternPC);
+#if PATTERN_SHOW_CYCLE
+  FW_STABLE(State, PatternShow);
+#endif
+  FW_STABLE(State, PatternLoopStart);
+  FW_STABLE(State, PatternLoopCount);
+  FW_STABLE(State, PatternLoopDepth);
+  FW_STABLE(State, PatternPalette);
+  FW_STABLE(State, PatternTempo);
+  FW_STABLE(State, PatternTempoLeft);
+  FW_STABLE(State, PatternTempoWide);
+  FW_STABLE(State, PatternFade);
+  FW_STABLE(State, PatternFadePending);
+  FW_STABLE(State, PatternLevel);
+  FW_STABLE(State, PatternTarget);
+  FW_STABLE(State, PatternFadeMs);
+  FW_STABLE(State, PatternFadeLeft);
+  FW_STABLE(State, PatternFadeShift);
+  FW_STABLE(State, PatternFadeDiff);
+  FW_STABLE(State, PatternFadeAcc);
+  FW_STABLE(State, PatternGenerating);
+  FW_STABLE(State, PatternGenerator);
+  FW_STABLE(State, PatternPhase);
+  FW_STABLE(State, PatternRandom);
+  FW_STABLE(State, PatternSpeed);
+  FW_STABLE(State, TimerHead);
+  FW_STABLE(State, TimerNext);
+  FW_STABLE(State, TimerDelta);
+  FW_STABLE(State, TimerRunning);
+  FW_STABLE(State, EventQueue);
+  FW_STABLE(State, EventHead);
+  FW_STABLE(State, EventTail);
+  FW_STABLE(State, EventsDropped);
+  FW_STABLE(State, EventsDroppedSeen);
+#if CLOCK_GOVERNOR
+  FW_STABLE(State, ClockShift);
+#endif
+#if TIMER_CALLBACKS
+  FW_STABLE(State, TimerCallback);
+#endif
+#if PWM_ENGINE == PWM_ENGINE_EDGE
+  FW_STABLE(State, PWMEdgeLATA);
+  FW_STABLE(State, PWMEdgeSpan);
+  FW_STABLE(State, PWMEdgeCount);
+  FW_STABLE(State, PWMEdge);
+#elif PWM_ENGINE == PWM_ENGINE_BAM
+  FW_STABLE(State, BAMBitLATA);
+  FW_STABLE(State, BAMSlot);
+#elif PWM_ENGINE == PWM_ENGINE_DITHER
+  FW_STABLE(State, LATALEDs);
+  FW_STABLE(State, DitherError);
+  FW_STABLE(State, DitherStart);
+  FW_STABLE(State, DitherStop);
+  FW_STABLE(State, DitherStep);
+#else
+  FW_STABLE(State, PWMCounter);
+#endif
+}
+
+uint32_t FW_MaxSkipMs(void)
+{
+  FwState_t State;
+  uint32_t Max = UINT32_MAX;
+
+  FW_GetState(&State);
+  for (uint8_t i = 0; i < State.TimerCount; i++)
+  {
+    if (State.Timers[i] && (State.Timers[i] - 1 < Max))
+    {
+      Max = State.Timers[i] - 1;
+    }
+  }
+  if ((WakeTimer <= MAX_AWAKE_TIME_MS) && (MAX_AWAKE_TIME_MS - WakeTimer < Max))
+  {
+    Max = MAX_AWAKE_TIME_MS - WakeTimer;
+  }
+  return Max;
+}
+
+void FW_Skip(uint32_t Ms)
+{
+  WakeTimer += Ms;
+  if (TimerCountdown)
+  {
+    TimerCountdown -= Ms;
+  }
+}
+
+#ifdef SIM_STRESS
+#define FW_SHARED(Var)        {#Var, (const volatile void *)&(Var), sizeof(Var)}
+
+// Everything one side writes that the other reads or writes
+const FwShared_t FW_Shared[] = {
+  FW_SHARED(WakeTimer),
+  FW_SHARED(LEDFrames),
+  FW_SHARED(LEDBrightness),
+  FW_SHARED(LEDFrameCommitted),
+  FW_SHARED(LEDFrameDoneWanted),
+  FW_SHARED(LEDFront),
+#if LED_FRAME_HANDLER
+  FW_SHARED(LEDFrameHandler),
+#endif
+#if CLOCK_GOVERNOR
+  FW_SHARED(ClockShift),
+#endif
+#if INPUT_DEBOUNCE == INPUT_DEBOUNCE_IOC
+  FW_SHARED(ButtonEdgeTime),
+  FW_SHARED(ButtonEdgePressed),
+  FW_SHARED(ButtonSettling),
+#else
+  FW_SHARED(DebouncedDown),
+  FW_SHARED(InputPresses),
+  FW_SHARED(InputReleases),
+  FW_SHARED(DebounceBusy),
+#endif
+  FW_SHARED(TimerHead),
+  FW_SHARED(TimerCountdown),
+  FW_SHARED(TimerNext),
+  FW_SHARED(TimerDelta),
+  FW_SHARED(TimerRunning),
+#if TIMER_CALLBACKS
+  FW_SHARED(TimerCallback),
+#endif
+  FW_SHARED(EventQueue),
+  FW_SHARED(EventHead),
+  FW_SHARED(EventTail),
+  FW_SHARED(EventsDropped),
+  {NULL, NULL, 0}
+};
+
+void FW_GetFrames(FwFrames_t *Frames)
+{
+  Frames->Frames = LEDFrames[0];
+  Frames->Front = (LEDFront == LEDFrames[0]) ? 0 : 1;
+  Frames->Committed = LEDFrameCommitted;
+}
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Learn To Solder 2019 host simulator
+ *
+ * Probes into the firmware's private state. firmware.c pulls main.c into its
+ * own translation unit so that these can read and adjust main.c's file-scope
+ * variables without the firmware having to export anything.
+ */
+
+#ifndef SIM_FIRMWARE_H
+#define SIM_FIRMWARE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FW_MAX_TIMERS         8
+#define FW_MAX_STABLE_BYTES   256
+
+typedef struct
+{
+  // Milliseconds the firmware believes it has been awake
+  uint32_t WakeTimer;
+
+  // Every software countdown timer decremented once per millisecond
+  uint8_t TimerCount;
+  uint32_t Timers[FW_MAX_TIMERS];
+
+  // Every other piece of state that steers what mainline and the ISR do
+  uint16_t StableSize;
+  uint8_t Stable[FW_MAX_STABLE_BYTES];
+} FwState_t;
+
+// Entry points into the firmware under test
+void firmware_main(void);
+void INTERRUPT_InterruptManager(void);
+
+// Interrupt cycle cost model: call FW_BeforeInterrupt just before
+// INTERRUPT_InterruptManager and FW_InterruptCycles just after it
+void FW_BeforeInterrupt(void);
+uint32_t FW_InterruptCycles(void);
+
+// How many of the last FW_InterruptCycles went on INTERRUPT_InterruptManager
+// getting to the handlers (RunTMR0 or RunOneMSTasks) and back, rather than on
+// the handlers themselves
+uint32_t FW_DispatchCycles(void);
+
+// Cycles from the start of the last interrupt given to FW_InterruptCycles to
+// where INTERRUPT_InterruptManager got to each source, or 0 if it didn't
+#define FW_SOURCE_TMR0        0
+#define FW_SOURCE_IOC         1
+#define FW_SOURCE_TMR2        2
+#define FW_SOURCE_COUNT       3
+uint32_t FW_ServiceCycles(int Source);
+
+// Cycles from the start of an interrupt to TMR0_ISR reloading TMR0
+uint32_t FW_ReloadLatencyCycles(void);
+
+uint32_t FW_WakeTimer(void);
+void FW_GetState(FwState_t *State);
+
+// Milliseconds that can pass before any timer or WakeTimer check fires
+uint32_t FW_MaxSkipMs(void);
+
+// Account for Ms milliseconds of 1ms ticks without running them
+void FW_Skip(uint32_t Ms);
+
+#ifdef SIM_STRESS
+// A variable mainline and the ISR both use
+typedef struct
+{
+  const char *Name;
+  const volatile void *Addr;
+  size_t Size;
+} FwShared_t;
+
+// Every shared variable the stress test watches, ending with a NULL Name
+extern const FwShared_t FW_Shared[];
+
+// The double buffered LED frames, FW_FRAME_SIZE bytes each, one after the
+// other
+#define FW_FRAME_SIZE         5
+typedef struct
+{
+  const volatile uint8_t *Frames;
+  int Front;                  // the frame the ISR is showing
+  bool Committed;             // mainline has committed the other one
+} FwFrames_t;
+
+void FW_GetFrames(FwFrames_t *Frames);
+#endif
+
+#endif // SIM_FIRMWARE_H
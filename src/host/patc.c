@@ -0,0 +1,827 @@
+/*
+ * Learn To Solder 2019 LED show compiler
+ *
+ * Compiles the text shows in pattern_shows.txt into the PatternCode[]
+ * bytecode RunPattern plays, written out as pattern_shows.h. See pattern.h
+ * for the bytecode, and pattern_shows.txt for the text it is written in.
+ *
+ *   patc INPUT OUTPUT
+ *
+ * INPUT is read twice: first to find the brightness levels each show's frames
+ * use, to give the show its palette, then to compile it. Each problem is
+ * reported against its line of INPUT, and OUTPUT is only written if there are
+ * none.
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pattern.h"
+
+// Largest PatternCode[] that 16 bit addresses can reach
+#define PATC_MAX_CODE         65535
+
+// PatternShows[] is indexed by a byte
+#define PATC_MAX_SHOWS        255
+
+#define PATC_MAX_NAME         32
+#define PATC_MAX_LINE         256
+
+// Steps out of one loop that can be waiting for its end
+#define PATC_MAX_BREAKS       16
+
+// Longest tempo curve
+#define PATC_MAX_TEMPO        255
+
+static const char *const OpNames[PATTERN_OP_COUNT] = {
+  "PATTERN_END",
+  "PATTERN_SET_FRAME",
+  "PATTERN_WAIT",
+  "PATTERN_WAIT_MS",
+  "PATTERN_SET_SPEED",
+  "PATTERN_TEMPO",
+  "PATTERN_TEMPO_WIDE",
+  "PATTERN_LOOP",
+  "PATTERN_NEXT",
+  "PATTERN_TEMPO_STEP",
+  "PATTERN_PALETTE",
+  "PATTERN_FRAME_2BIT",
+  "PATTERN_FRAME_4BIT",
+  "PATTERN_FADE",
+  "PATTERN_WAVE",
+  "PATTERN_SCAN",
+  "PATTERN_FLICKER",
+  "PATTERN_SPARKLE",
+};
+
+// The text for each PatternFade_t
+static const char *const FadeNames[PATTERN_FADE_COUNT] = {
+  "off",
+  "linear",
+  "ease",
+};
+
+typedef struct
+{
+  char Name[PATC_MAX_NAME];
+  uint16_t Start;
+
+  // Its frames' levels, lowest first, found by the first pass. A show with
+  // more than PATTERN_PALETTE_SIZE has no palette.
+  int LevelCount;
+  uint8_t Levels[PATTERN_PALETTE_SIZE];
+} Show_t;
+
+// A loop waiting for its next
+typedef struct
+{
+  bool Forever;
+  bool Waits;                 // something in it waits
+  int BreakCount;
+  uint16_t Breaks[PATC_MAX_BREAKS];   // where each step's end address goes
+} Loop_t;
+
+static const char *InputPath;
+static int LineNumber;
+
+static uint8_t Code[PATC_MAX_CODE];
+static uint32_t CodeSize;
+
+// Where each instruction starts, to lay the output out one to a line
+static bool InstructionStart[PATC_MAX_CODE];
+
+// A note to show alongside each instruction that has one: a packed frame's
+// levels, a fade's name, or a generator or tempo curve as it was written
+static char *Comments[PATC_MAX_CODE];
+
+static Show_t Shows[PATC_MAX_SHOWS];
+static int ShowCount;
+static bool InShow;
+static bool ShowHasTempo;
+
+// Whether a speed or step comes before this point in the show, so a wait
+// without a time of its own doesn't take no time and let a loop spin
+static bool ShowHasSpeed;
+
+// Whether the show being compiled ever fades, and its longest wait, speed or
+// tempo step with the line it's on: a fade only lasts PATTERN_FADE_MAX_MS
+static bool ShowFades;
+static uint32_t ShowLongest;
+static int ShowLongestLine;
+
+static Loop_t Loops[PATTERN_LOOP_DEPTH];
+static int LoopDepth;
+
+static void Fail(const char *Format, ...)
+{
+  va_list Args;
+
+  fprintf(stderr, "%s:%d: ", InputPath, LineNumber);
+  va_start(Args, Format);
+  vfprintf(stderr, Format, Args);
+  va_end(Args);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+static uint32_t ParseNumber(const char *Text, uint32_t Min, uint32_t Max, const char *What)
+{
+  char *End;
+  unsigned long Value;
+
+  if (!Text)
+  {
+    Fail("missing %s", What);
+  }
+  Value = strtoul(Text, &End, 0);
+  if ((End == Text) || (*End != '\0'))
+  {
+    Fail("invalid %s: %s", What, Text);
+  }
+  if ((Value < Min) || (Value > Max))
+  {
+    Fail("%s must be %u to %u: %s", What, Min, Max, Text);
+  }
+  return (uint32_t)Value;
+}
+
+// Start an instruction
+static void EmitOp(PatternOp_t Op)
+{
+  if (!InShow)
+  {
+    Fail("instruction outside a show");
+  }
+  if (CodeSize == PATC_MAX_CODE)
+  {
+    Fail("shows too long");
+  }
+  InstructionStart[CodeSize] = true;
+  Code[CodeSize++] = (uint8_t)Op;
+}
+
+static void EmitByte(uint8_t Value)
+{
+  if (CodeSize == PATC_MAX_CODE)
+  {
+    Fail("shows too long");
+  }
+  Code[CodeSize++] = Value;
+}
+
+static void EmitWord(uint16_t Value)
+{
+  EmitByte((uint8_t)Value);
+  EmitByte((uint8_t)(Value >> 8));
+}
+
+static void PatchWord(uint16_t At, uint16_t Value)
+{
+  Code[At] = (uint8_t)Value;
+  Code[At + 1] = (uint8_t)(Value >> 8);
+}
+
+// The rest of the line must be empty
+static void NoMore(void)
+{
+  const char *Extra = strtok(NULL, " \t");
+
+  if (Extra)
+  {
+    Fail("unexpected %s", Extra);
+  }
+}
+
+// Phase step per ms for a sine wave of Period ms
+static uint16_t PhaseStep(uint32_t Period)
+{
+  return (uint16_t)((65536 + Period / 2) / Period);
+}
+
+static uint8_t ParseMask(const char *Text, uint32_t Max, const char *What)
+{
+  uint32_t Value = ParseNumber(Text, 1, Max, What);
+
+  if (Value & (Value - 1))
+  {
+    Fail("%s must be a power of 2: %s", What, Text);
+  }
+  return (uint8_t)(Value - 1);
+}
+
+static void EmitNoted(PatternOp_t Op, const char *Format, ...)
+{
+  char Comment[64];
+  va_list Args;
+
+  va_start(Args, Format);
+  vsnprintf(Comment, sizeof(Comment), Format, Args);
+  va_end(Args);
+  Comments[CodeSize] = strdup(Comment);
+  EmitOp(Op);
+}
+
+/* How far along an ease curve to be at T, from 0 at the start to 1 at the end,
+ * for "ease-in", "ease-out" or "bounce": the usual easing functions, with the
+ * bounce dropping onto the end three times.
+ */
+static double Ease(const char *Kind, double T)
+{
+  if (!strcmp(Kind, "ease-in"))
+  {
+    return T * T;
+  }
+  if (!strcmp(Kind, "ease-out"))
+  {
+    return 1 - (1 - T) * (1 - T);
+  }
+  if (T < 1 / 2.75)
+  {
+    return 7.5625 * T * T;
+  }
+  if (T < 2 / 2.75)
+  {
+    T -= 1.5 / 2.75;
+    return 7.5625 * T * T + 0.75;
+  }
+  if (T < 2.5 / 2.75)
+  {
+    T -= 2.25 / 2.75;
+    return 7.5625 * T * T + 0.9375;
+  }
+  T -= 2.625 / 2.75;
+  return 7.5625 * T * T + 0.984375;
+}
+
+// Note a time that a wait in the show can take
+static void WaitTime(uint32_t Ms)
+{
+  if (Ms > ShowLongest)
+  {
+    ShowLongest = Ms;
+    ShowLongestLine = LineNumber;
+  }
+}
+
+// Compile the rest of a tempo line: its curve's kind and numbers. The curve
+// takes a byte a step if they all fit.
+static void CompileTempo(void)
+{
+  uint16_t Steps[PATC_MAX_TEMPO];
+  PatternOp_t Op = PATTERN_TEMPO;
+  char *Kind = strtok(NULL, " \t");
+  char Note[64];
+  char *Arg;
+  uint32_t From;
+  uint32_t To;
+  int Count = 0;
+
+  if (!Kind)
+  {
+    Fail("tempo needs a curve: exp, ease-in, ease-out or bounce");
+  }
+  From = ParseNumber(strtok(NULL, " \t"), 1, 65535, "first step time");
+  if (!strcmp(Kind, "exp"))
+  {
+    uint32_t Num;
+    uint32_t Den;
+    uint32_t Ms = From;
+
+    // Scaled the way a multiply and divide at run time would, rounding down
+    Arg = strtok(NULL, " \t");
+    if (!Arg || !strchr(Arg, '/'))
+    {
+      Fail("exp needs a ratio, such as 8/10");
+    }
+    *strchr(Arg, '/') = '\0';
+    Num = ParseNumber(Arg, 1, 255, "exp multiplier");
+    Den = ParseNumber(Arg + strlen(Arg) + 1, 1, 255, "exp divisor");
+    To = ParseNumber(strtok(NULL, " \t"), 1, 65535, "last step time");
+    if (Num == Den)
+    {
+      Fail("exp ratio never changes the step time");
+    }
+    for (;;)
+    {
+      Ms = Ms * Num / Den;
+      if ((Num < Den) ? (Ms < To) : (Ms > To))
+      {
+        break;
+      }
+      if (Count == PATC_MAX_TEMPO)
+      {
+        Fail("tempo curve longer than %d steps", PATC_MAX_TEMPO);
+      }
+      Steps[Count++] = (uint16_t)Ms;
+    }
+    if (Count == 0)
+    {
+      Fail("tempo curve has no steps");
+    }
+    snprintf(Note, sizeof(Note), "exp %u %u/%u %u", From, Num, Den, To);
+  }
+  else if (!strcmp(Kind, "ease-in") || !strcmp(Kind, "ease-out") || !strcmp(Kind, "bounce"))
+  {
+    To = ParseNumber(strtok(NULL, " \t"), 1, 65535, "last step time");
+    Count = (int)ParseNumber(strtok(NULL, " \t"), 2, PATC_MAX_TEMPO, "number of steps");
+    for (int i = 0; i < Count; i++)
+    {
+      double Ms = From + ((double)To - From) * Ease(Kind, (double)i / (Count - 1));
+
+      Steps[i] = (uint16_t)(Ms + 0.5);
+    }
+    snprintf(Note, sizeof(Note), "%s %u %u %d", Kind, From, To, Count);
+  }
+  else
+  {
+    Fail("unknown tempo curve %s", Kind);
+  }
+
+  for (int i = 0; i < Count; i++)
+  {
+    if (Steps[i] > 255)
+    {
+      Op = PATTERN_TEMPO_WIDE;
+    }
+  }
+  EmitNoted(Op, "%s", Note);
+  EmitByte((uint8_t)Count);
+  for (int i = 0; i < Count; i++)
+  {
+    WaitTime(Steps[i]);
+    if (Op == PATTERN_TEMPO_WIDE)
+    {
+      EmitWord(Steps[i]);
+    }
+    else
+    {
+      EmitByte((uint8_t)Steps[i]);
+    }
+  }
+  ShowHasTempo = true;
+}
+
+// Mark every open loop as waiting
+static void Waits(void)
+{
+  for (int i = 0; i < LoopDepth; i++)
+  {
+    Loops[i].Waits = true;
+  }
+}
+
+static void ParseFrame(uint8_t Frame[5])
+{
+  for (int i = 0; i < 5; i++)
+  {
+    Frame[i] = (uint8_t)ParseNumber(strtok(NULL, " \t"), 0, 255, "brightness");
+  }
+}
+
+// Add a frame's levels to Show's palette
+static void CollectLevels(Show_t *Show, const uint8_t Frame[5])
+{
+  for (int i = 0; i < 5; i++)
+  {
+    int At = 0;
+
+    if (Show->LevelCount > PATTERN_PALETTE_SIZE)
+    {
+      return;
+    }
+    while ((At < Show->LevelCount) && (Show->Levels[At] < Frame[i]))
+    {
+      At++;
+    }
+    if ((At < Show->LevelCount) && (Show->Levels[At] == Frame[i]))
+    {
+      continue;
+    }
+    if (Show->LevelCount == PATTERN_PALETTE_SIZE)
+    {
+      Show->LevelCount++;
+      return;
+    }
+    memmove(&Show->Levels[At + 1], &Show->Levels[At], (size_t)(Show->LevelCount - At));
+    Show->Levels[At] = Frame[i];
+    Show->LevelCount++;
+  }
+}
+
+// First pass: find each show's levels. Everything else, and any problem
+// other than a bad level, is left for CompileLine to deal with.
+static void CollectLine(char *Line)
+{
+  uint8_t Frame[5];
+  char *Word;
+
+  Line[strcspn(Line, "#\r\n")] = '\0';
+  Word = strtok(Line, " \t");
+  if (!Word)
+  {
+    return;
+  }
+  if (!strcmp(Word, "show"))
+  {
+    ShowCount++;
+  }
+  else if (!strcmp(Word, "frame") && (ShowCount > 0) && (ShowCount <= PATC_MAX_SHOWS))
+  {
+    ParseFrame(Frame);
+    CollectLevels(&Shows[ShowCount - 1], Frame);
+  }
+}
+
+static void EmitFrame(const uint8_t Frame[5])
+{
+  const Show_t *Show = &Shows[ShowCount - 1];
+  uint8_t Index[5];
+  char Comment[32];
+
+  if (Show->LevelCount > PATTERN_PALETTE_SIZE)
+  {
+    EmitOp(PATTERN_SET_FRAME);
+    for (int i = 0; i < 5; i++)
+    {
+      EmitByte(Frame[i]);
+    }
+    return;
+  }
+
+  for (int i = 0; i < 5; i++)
+  {
+    Index[i] = (uint8_t)((const uint8_t *)memchr(Show->Levels, Frame[i],
+                                                  (size_t)Show->LevelCount) - Show->Levels);
+  }
+  snprintf(Comment, sizeof(Comment), "%u %u %u %u %u",
+           Frame[0], Frame[1], Frame[2], Frame[3], Frame[4]);
+  Comments[CodeSize] = strdup(Comment);
+  if (Show->LevelCount <= 4)
+  {
+    EmitOp(PATTERN_FRAME_2BIT);
+    EmitWord((uint16_t)(Index[0] | (Index[1] << 2) | (Index[2] << 4) | (Index[3] << 6) |
+                        (Index[4] << 8)));
+  }
+  else
+  {
+    EmitOp(PATTERN_FRAME_4BIT);
+    EmitByte((uint8_t)(Index[0] | (Index[1] << 4)));
+    EmitByte((uint8_t)(Index[2] | (Index[3] << 4)));
+    EmitByte(Index[4]);
+  }
+}
+
+static void CompileLine(char *Line)
+{
+  char *Word;
+  char *Arg;
+
+  Line[strcspn(Line, "#\r\n")] = '\0';
+  Word = strtok(Line, " \t");
+  if (!Word)
+  {
+    return;
+  }
+
+  if (!strcmp(Word, "show"))
+  {
+    Show_t *Show;
+
+    Arg = strtok(NULL, " \t");
+    if (InShow)
+    {
+      Fail("show %s doesn't end", Shows[ShowCount - 1].Name);
+    }
+    if (!Arg || (strlen(Arg) >= PATC_MAX_NAME))
+    {
+      Fail("show needs a name of up to %d characters", PATC_MAX_NAME - 1);
+    }
+    if (ShowCount == PATC_MAX_SHOWS)
+    {
+      Fail("more than %d shows", PATC_MAX_SHOWS);
+    }
+    strcpy(Shows[ShowCount].Name, Arg);
+    Shows[ShowCount++].Start = (uint16_t)CodeSize;
+    InShow = true;
+    ShowHasTempo = false;
+    ShowHasSpeed = false;
+    ShowFades = false;
+    ShowLongest = 0;
+
+    Show = &Shows[ShowCount - 1];
+    if ((Show->LevelCount > 0) && (Show->LevelCount <= PATTERN_PALETTE_SIZE))
+    {
+      EmitOp(PATTERN_PALETTE);
+      EmitByte((uint8_t)Show->LevelCount);
+      for (int i = 0; i < Show->LevelCount; i++)
+      {
+        EmitByte(Show->Levels[i]);
+      }
+    }
+  }
+  else if (!strcmp(Word, "frame"))
+  {
+    uint8_t Frame[5];
+
+    ParseFrame(Frame);
+    EmitFrame(Frame);
+  }
+  else if (!strcmp(Word, "wait"))
+  {
+    Arg = strtok(NULL, " \t");
+    if (Arg)
+    {
+      uint32_t Ms = ParseNumber(Arg, 1, 65535, "wait");
+
+      EmitOp(PATTERN_WAIT_MS);
+      EmitWord((uint16_t)Ms);
+      WaitTime(Ms);
+    }
+    else
+    {
+      if (!ShowHasSpeed)
+      {
+        Fail("wait before a speed or step");
+      }
+      EmitOp(PATTERN_WAIT);
+    }
+    Waits();
+  }
+  else if (!strcmp(Word, "speed"))
+  {
+    uint32_t Ms = ParseNumber(strtok(NULL, " \t"), 1, 65535, "speed");
+
+    EmitOp(PATTERN_SET_SPEED);
+    EmitWord((uint16_t)Ms);
+    WaitTime(Ms);
+    ShowHasSpeed = true;
+  }
+  else if (!strcmp(Word, "tempo"))
+  {
+    CompileTempo();
+  }
+  else if (!strcmp(Word, "loop"))
+  {
+    Arg = strtok(NULL, " \t");
+    if (LoopDepth == PATTERN_LOOP_DEPTH)
+    {
+      Fail("loops nested more than %d deep", PATTERN_LOOP_DEPTH);
+    }
+    EmitOp(PATTERN_LOOP);
+    EmitByte(Arg ? (uint8_t)ParseNumber(Arg, 1, 255, "loop count") : 0);
+    Loops[LoopDepth++] = (Loop_t){.Forever = !Arg};
+  }
+  else if (!strcmp(Word, "next"))
+  {
+    Loop_t *Loop;
+
+    if (LoopDepth == 0)
+    {
+      Fail("next without a loop");
+    }
+    Loop = &Loops[LoopDepth - 1];
+    EmitOp(PATTERN_NEXT);
+    if (Loop->Forever && !Loop->Waits)
+    {
+      Fail("loop without a count never waits");
+    }
+    for (int i = 0; i < Loop->BreakCount; i++)
+    {
+      PatchWord(Loop->Breaks[i], (uint16_t)CodeSize);
+    }
+    LoopDepth--;
+  }
+  else if (!strcmp(Word, "step"))
+  {
+    Loop_t *Loop;
+
+    if (LoopDepth == 0)
+    {
+      Fail("step outside a loop");
+    }
+    if (!ShowHasTempo)
+    {
+      Fail("step before a tempo");
+    }
+    Loop = &Loops[LoopDepth - 1];
+    if (Loop->BreakCount == PATC_MAX_BREAKS)
+    {
+      Fail("more than %d steps in one loop", PATC_MAX_BREAKS);
+    }
+    EmitOp(PATTERN_TEMPO_STEP);
+    Loop->Breaks[Loop->BreakCount++] = (uint16_t)CodeSize;
+    EmitWord(0);
+    ShowHasSpeed = true;
+  }
+  else if (!strcmp(Word, "fade"))
+  {
+    int Fade = 0;
+
+    Arg = strtok(NULL, " \t");
+    while ((Fade < PATTERN_FADE_COUNT) && (!Arg || strcmp(Arg, FadeNames[Fade])))
+    {
+      Fade++;
+    }
+    if (Fade == PATTERN_FADE_COUNT)
+    {
+      Fail("fade needs off, linear or ease");
+    }
+    Comments[CodeSize] = strdup(FadeNames[Fade]);
+    EmitOp(PATTERN_FADE);
+    EmitByte((uint8_t)Fade);
+    if (Fade != PATTERN_FADE_OFF)
+    {
+      ShowFades = true;
+    }
+  }
+  else if (!strcmp(Word, "wave"))
+  {
+    uint32_t Period = ParseNumber(strtok(NULL, " \t"), 2, 65535, "wave period");
+    uint32_t Stagger = ParseNumber(strtok(NULL, " \t"), 0, 359, "stagger");
+    uint32_t Dim = ParseNumber(strtok(NULL, " \t"), 0, 7, "dim");
+
+    EmitNoted(PATTERN_WAVE, "wave %u %u %u", Period, Stagger, Dim);
+    EmitWord(PhaseStep(Period));
+    EmitWord((uint16_t)((Stagger * 65536 + 180) / 360));
+    EmitByte((uint8_t)Dim);
+  }
+  else if (!strcmp(Word, "scan"))
+  {
+    uint32_t Period = ParseNumber(strtok(NULL, " \t"), 2, 65535, "scan period");
+    uint32_t Dim = ParseNumber(strtok(NULL, " \t"), 0, 7, "dim");
+
+    EmitNoted(PATTERN_SCAN, "scan %u %u", Period, Dim);
+    EmitWord(PhaseStep(Period));
+    EmitByte((uint8_t)Dim);
+  }
+  else if (!strcmp(Word, "flicker"))
+  {
+    uint32_t Ms = ParseNumber(strtok(NULL, " \t"), 1, 255, "flicker time");
+    uint32_t Base = ParseNumber(strtok(NULL, " \t"), 0, 255, "flicker level");
+    uint8_t Mask = ParseMask(strtok(NULL, " \t"), 256, "flicker range");
+
+    if (Base + Mask > 255)
+    {
+      Fail("flicker level and range go over 255");
+    }
+    EmitNoted(PATTERN_FLICKER, "flicker %u %u %u", Ms, Base, Mask + 1);
+    EmitByte((uint8_t)Ms);
+    EmitByte((uint8_t)Base);
+    EmitByte(Mask);
+  }
+  else if (!strcmp(Word, "sparkle"))
+  {
+    uint32_t Ms = ParseNumber(strtok(NULL, " \t"), 1, 255, "sparkle time");
+    uint8_t Chance = ParseMask(strtok(NULL, " \t"), 256, "sparkle chance");
+    uint32_t Level = ParseNumber(strtok(NULL, " \t"), 1, 255, "sparkle level");
+
+    EmitNoted(PATTERN_SPARKLE, "sparkle %u %u %u", Ms, Chance + 1, Level);
+    EmitByte((uint8_t)Ms);
+    EmitByte(Chance);
+    EmitByte((uint8_t)Level);
+  }
+  else if (!strcmp(Word, "end"))
+  {
+    if (LoopDepth)
+    {
+      Fail("end inside a loop");
+    }
+    if (ShowFades && (ShowLongest > PATTERN_FADE_MAX_MS))
+    {
+      Fail("show %s fades, but line %d waits %u ms, over the %u ms a fade can take",
+           Shows[ShowCount - 1].Name, ShowLongestLine, ShowLongest, PATTERN_FADE_MAX_MS);
+    }
+    EmitOp(PATTERN_END);
+    InShow = false;
+  }
+  else
+  {
+    Fail("unknown instruction %s", Word);
+  }
+  NoMore();
+}
+
+static void WriteHeader(FILE *Out, const char *Source)
+{
+  const char *Name = strrchr(Source, '/') ? strrchr(Source, '/') + 1 : Source;
+  const char *Comment = NULL;
+
+  fprintf(Out,
+          "/*\n"
+          " * Learn To Solder 2019 board software\n"
+          " *\n"
+          " * LED shows, compiled from %s by patc. Don't edit: change\n"
+          " * %s and run make -C src/host patterns.\n"
+          " */\n"
+          "\n"
+          "#ifndef PATTERN_SHOWS_H\n"
+          "#define PATTERN_SHOWS_H\n"
+          "\n"
+          "#include <stdint.h>\n"
+          "\n"
+          "#include \"pattern.h\"\n"
+          "\n"
+          "#define PATTERN_SHOW_COUNT    %d\n"
+          "\n"
+          "static const uint8_t PatternCode[%u] = {",
+          Name, Name, ShowCount, CodeSize);
+
+  for (uint32_t i = 0, Show = 0; i < CodeSize; i++)
+  {
+    if (InstructionStart[i])
+    {
+      if ((Show < (uint32_t)ShowCount) && (Shows[Show].Start == i))
+      {
+        fprintf(Out, "%s\n  // %s", i ? "\n" : "", Shows[Show++].Name);
+      }
+      fprintf(Out, "\n  %s,", OpNames[Code[i]]);
+    }
+    else
+    {
+      fprintf(Out, " %u,", Code[i]);
+    }
+    if (InstructionStart[i])
+    {
+      Comment = Comments[i];
+    }
+    if (Comment && ((i + 1 == CodeSize) || InstructionStart[i + 1]))
+    {
+      fprintf(Out, "    // %s", Comment);
+    }
+  }
+  fprintf(Out,
+          "\n};\n"
+          "\n"
+          "// Where each show starts in PatternCode\n"
+          "static const uint16_t PatternShows[PATTERN_SHOW_COUNT] = {\n");
+  for (int i = 0; i < ShowCount; i++)
+  {
+    fprintf(Out, "  %u,    // %s\n", Shows[i].Start, Shows[i].Name);
+  }
+  fprintf(Out,
+          "};\n"
+          "\n"
+          "#endif // PATTERN_SHOWS_H\n");
+}
+
+int main(int argc, char **argv)
+{
+  char Line[PATC_MAX_LINE];
+  FILE *In;
+  FILE *Out;
+
+  if (argc != 3)
+  {
+    fprintf(stderr, "Usage: %s INPUT OUTPUT\n", argv[0]);
+    return 2;
+  }
+  InputPath = argv[1];
+  In = fopen(InputPath, "r");
+  if (!In)
+  {
+    perror(InputPath);
+    return 1;
+  }
+  while (fgets(Line, sizeof(Line), In))
+  {
+    LineNumber++;
+    CollectLine(Line);
+  }
+  rewind(In);
+  ShowCount = 0;
+  LineNumber = 0;
+  while (fgets(Line, sizeof(Line), In))
+  {
+    LineNumber++;
+    CompileLine(Line);
+  }
+  fclose(In);
+  if (InShow)
+  {
+    Fail("show %s doesn't end", Shows[ShowCount - 1].Name);
+  }
+  if (ShowCount == 0)
+  {
+    Fail("no shows");
+  }
+
+  Out = fopen(argv[2], "w");
+  if (!Out)
+  {
+    perror(argv[2]);
+    return 1;
+  }
+  WriteHeader(Out, InputPath);
+  if (fclose(Out))
+  {
+    perror(argv[2]);
+    return 1;
+  }
+  printf("%s: %d show%s, %u bytes\n", argv[2], ShowCount, (ShowCount == 1) ? "" : "s",
+         CodeSize);
+  return 0;
+}
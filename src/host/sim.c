@@ -0,0 +1,1985 @@
+/*
+ * Learn To Solder 2019 host simulator
+ *
+ * Runs the unmodified board firmware (main.c and mcc_generated_files) on Linux
+ * against the fake SFRs declared in xc.h.
+ *
+ * Time is kept in PIC instruction cycles (Fosc/4). Mainline code is charged a
+ * fixed number of cycles each time it reads PORTA or runs a NOP (one of which
+ * the main loop does on every pass, working or waiting), and each interrupt is
+ * charged what the path it took would cost on the chip, from the cost model
+ * in firmware.c. Timer0 is clocked from those cycles through its prescaler
+ * exactly as on the chip, including the prescaler clear when the ISR reloads
+ * TMR0, so INTERRUPT_InterruptManager is called at the real TMR0 rate for the
+ * current OSCCON and OPTION_REG settings. Timer2 runs from the same cycles
+ * through its prescaler, PR2 match and postscaler.
+ *
+ * Pins driven by the 16 bit PWM modules are credited with the module's duty
+ * cycle as their on-time rather than switching at each PWM edge.
+ *
+ * The current drawn by the LEDs is reported as its peak, RMS and mean while
+ * the board is on, taking each lit LED to draw --led-current mA, along with
+ * how long each number of LEDs was lit at once. The RMS current is what sets
+ * the loss in the coin cell's internal resistance. The PWM modules run from
+ * their own clock, so the LEDs they drive are counted by how their edges fall
+ * within a PWM period, independently of the pins RunTMR0 drives. The PIC's
+ * own current is modelled as --run-current at 16MHz, scaling down with the
+ * clock apart from its --static-current, and --sleep-current while the clock
+ * is stopped. It is compared against what it would have drawn awake at 16MHz
+ * the whole time.
+ *
+ * The push button on RA3 is driven from a script given on the command line,
+ * with optional contact bounce, and raises IOC flags the same way the pin would.
+ * SLEEP stops the instruction clock, Timer0 and Timer2 until an IOC edge wakes
+ * the part up, or, if SWDTEN is set, the watchdog runs out. A sleep with the
+ * watchdog running is the firmware idling between events, and the board
+ * counts as on through it. One without is the board switching itself off.
+ *
+ * At the end of a run the simulator reports the best, typical (most common)
+ * and worst interrupt cost in cycles, how much of it INTERRUPT_InterruptManager
+ * spent dispatching to the handlers, the longest any interrupt source waited
+ * from its flag being set to being serviced, and how the awake CPU time was
+ * split between interrupts and the main loop. It also checks the firmware's
+ * millisecond timebase against simulated time: how many milliseconds WakeTimer
+ * counted while awake, the drift from the time that actually passed, and the
+ * shortest and longest time between two ticks.
+ *
+ * With --fast the simulator skips ahead through stretches where nothing
+ * changes. Every time WakeTimer reaches a multiple of --fast-window ms it takes
+ * a checkpoint. When two consecutive spans of one or more windows produced
+ * exactly the same cycles, interrupts and LED on-time, and the firmware's state
+ * only differs by its countdown timers having moved on by one span, further
+ * spans are accounted for arithmetically up to the next timer expiry, input
+ * edge or WakeTimer limit. TMR0 and Timer2 may also have moved on by the
+ * cycles of a span, as they do across watchdog wakes, in which case the spans
+ * stop short of their next interrupt. A main loop waiting awake is carried on
+ * through the same number of passes it would have run. The results are
+ * identical to a tick-by-tick run.
+ *
+ * make stress builds a version that interrupts mainline at every point it can
+ * be interrupted at, to look for races over the variables it shares with the
+ * ISR. See stress.h.
+ *
+ * Run with --help for the options.
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "xc.h"
+#include "firmware.h"
+#ifdef SIM_STRESS
+#include "stress.h"
+#endif
+
+#define PS_PER_MS             1000000000ULL
+
+// Bit positions of each LED within Port A (see main.c)
+#define LED_COUNT             5
+static const uint8_t LEDPins[LED_COUNT] = {0x01, 0x02, 0x04, 0x10, 0x20};
+#define LED_PINS              0x37
+
+// LED on each Port A bit, for the pins that have one
+static const uint8_t PinLED[8] = {0, 1, 2, 0, 3, 4, 0, 0};
+
+// Push button input, pressed = low
+#define BUTTON_PIN            0x08
+
+// Interrupt costs of this many cycles or more share the last histogram bucket
+#define ISR_HISTOGRAM_SIZE    1024
+
+// LFINTOSC, which clocks the watchdog
+#define LFINTOSC_HZ           31000ULL
+
+// Clock that --run-current is given for
+#define RUN_CURRENT_HZ        16000000ULL
+
+// Largest WDTPS, 1:8388608. Higher values are reserved.
+#define WDTPS_MAX             18
+
+// Length of one bounce pulse when --bounce is used
+#define BOUNCE_PS             (100ULL * 1000000ULL)
+
+// Options only the stress build has
+#ifdef SIM_STRESS
+#define STRESS_OPTIONS        "P:"
+#else
+#define STRESS_OPTIONS        ""
+#endif
+
+/*
+  Fake SFRs
+*/
+volatile INTCONbits_t INTCONbits;
+volatile STATUSbits_t STATUSbits;
+volatile OPTION_REGbits_t OPTION_REGbits;
+volatile uint8_t TMR0;
+volatile PIR1bits_t PIR1bits;
+volatile PIE1bits_t PIE1bits;
+volatile T2CONbits_t T2CONbits;
+volatile uint8_t TMR2;
+volatile uint8_t PR2;
+volatile LATAbits_t LATAbits;
+volatile TRISAbits_t TRISAbits;
+volatile ANSELAbits_t ANSELAbits;
+volatile WPUAbits_t WPUAbits;
+volatile ODCONAbits_t ODCONAbits;
+volatile APFCONbits_t APFCONbits;
+volatile IOCAPbits_t IOCAPbits;
+volatile IOCANbits_t IOCANbits;
+volatile IOCAFbits_t IOCAFbits;
+volatile OSCCONbits_t OSCCONbits;
+volatile uint8_t OSCTUNE;
+volatile uint8_t BORCON;
+volatile WDTCONbits_t WDTCONbits;
+volatile VREGCONbits_t VREGCONbits;
+
+volatile PWM1CONbits_t PWM1CONbits;
+volatile PWM1CLKCONbits_t PWM1CLKCONbits;
+volatile PWM1LDCONbits_t PWM1LDCONbits;
+volatile uint8_t PWM1INTE;
+volatile uint8_t PWM1INTF;
+volatile uint8_t PWM1OFCON;
+volatile uint16_t PWM1PH;
+volatile uint16_t PWM1DC;
+volatile uint16_t PWM1PR;
+volatile PWM2CONbits_t PWM2CONbits;
+volatile PWM2CLKCONbits_t PWM2CLKCONbits;
+volatile PWM2LDCONbits_t PWM2LDCONbits;
+volatile uint8_t PWM2INTE;
+volatile uint8_t PWM2INTF;
+volatile uint8_t PWM2OFCON;
+volatile uint16_t PWM2PH;
+volatile uint16_t PWM2DC;
+volatile uint16_t PWM2PR;
+volatile PWM3CONbits_t PWM3CONbits;
+volatile PWM3CLKCONbits_t PWM3CLKCONbits;
+volatile PWM3LDCONbits_t PWM3LDCONbits;
+volatile uint8_t PWM3INTE;
+volatile uint8_t PWM3INTF;
+volatile uint8_t PWM3OFCON;
+volatile uint16_t PWM3PH;
+volatile uint16_t PWM3DC;
+volatile uint16_t PWM3PR;
+
+static volatile PORTAbits_t PortA;
+
+/*
+  16 bit PWM modules
+*/
+#define PWMCON_EN             0x80
+#define PWMCON_OE             0x40
+#define PWMCON_POL            0x10
+#define PWMLDCON_LDA          0x80
+
+typedef struct
+{
+  volatile uint8_t *Con;
+  volatile uint8_t *LdCon;
+  volatile uint16_t *Ph;
+  volatile uint16_t *Dc;
+  volatile uint16_t *Pr;
+  uint8_t Pin;                // output pin with the APFCON select bit clear
+  uint8_t AltPin;             // and with it set
+  uint8_t Select;             // APFCON select bit
+  uint16_t Phase;             // values last loaded from the buffers
+  uint16_t Duty;
+  uint16_t Period;
+  bool Driving;               // output reaches an LED pin
+  bool Inverted;              // lit outside Start to End rather than inside
+  uint32_t Start;             // counts within the period the output is active
+  uint32_t End;
+} PwmModule_t;
+
+static PwmModule_t PwmModules[] =
+{
+  {&PWM1CON, &PWM1LDCON, &PWM1PH, &PWM1DC, &PWM1PR, 0x02, 0x20, 0x01, 0, 0, 0, false, false, 0, 0},
+  {&PWM2CON, &PWM2LDCON, &PWM2PH, &PWM2DC, &PWM2PR, 0x01, 0x10, 0x02, 0, 0, 0, false, false, 0, 0},
+  {&PWM3CON, &PWM3LDCON, &PWM3PH, &PWM3DC, &PWM3PR, 0x04, 0x04, 0x00, 0, 0, 0, false, false, 0, 0},
+};
+#define PWM_MODULES           (sizeof(PwmModules) / sizeof(PwmModules[0]))
+
+// Pins driven by a PWM module, and each LED's on count out of its period
+static uint8_t PwmPins;
+static uint32_t PwmOn[LED_COUNT];
+static uint32_t PwmPeriod[LED_COUNT];
+
+// Counts of the PWM period during which each number of the LEDs on PWM pins
+// are lit. The modules are taken to share one period, as the firmware sets
+// them up.
+static uint32_t PwmLit[PWM_MODULES + 1];
+static uint32_t PwmLitPeriod;
+
+/*
+  Command line options
+*/
+typedef struct
+{
+  uint64_t EndPs;
+  uint32_t LoopCycles;
+  uint32_t IsrCycles;
+  uint32_t IsrLatencyCycles;
+  uint32_t BounceEdges;
+  uint32_t TraceWindowMs;
+  uint32_t FastWindowMs;
+  uint32_t LEDMilliamps;
+  uint32_t RunMicroamps;
+  uint32_t StaticMicroamps;
+  uint32_t SleepMicroamps;
+#ifdef SIM_STRESS
+  uint32_t PreemptEvery;
+#endif
+  bool Trace;
+  bool Fast;
+} Options_t;
+
+static Options_t Options = {
+  .EndPs = 10000ULL * PS_PER_MS,
+  .LoopCycles = 40,
+  .IsrCycles = 0,
+  .IsrLatencyCycles = 0,
+  .BounceEdges = 0,
+  .TraceWindowMs = 64,
+  .FastWindowMs = 256,
+  .LEDMilliamps = 10,
+  .RunMicroamps = 1000,
+  .StaticMicroamps = 100,
+  .SleepMicroamps = 1,
+#ifdef SIM_STRESS
+  .PreemptEvery = 1,
+#endif
+  .Trace = false,
+  .Fast = false,
+};
+
+/*
+  Scripted button input
+*/
+typedef struct
+{
+  uint64_t TimePs;
+  bool Pressed;
+} InputEvent_t;
+
+static InputEvent_t *InputEvents;
+static size_t InputEventCount;
+static size_t NextInputEvent;
+static bool ButtonDown;
+
+/*
+  Simulation state
+*/
+static uint64_t TimePs;
+static uint64_t Cycles;
+static uint32_t PsRemainder;
+static uint32_t Tmr0PrescaleCount;
+static uint8_t Tmr0Shadow;
+static uint32_t Tmr2PrescaleCount;
+static uint32_t Tmr2PostscaleCount;
+static uint8_t Tmr2Shadow;
+static uint8_t T2ConShadow;
+static uint64_t FlagCycles[FW_SOURCE_COUNT];
+static bool Running;
+static bool Asleep;
+static bool IdleSleep;
+static bool InInterrupt;
+// Set for the whole of RunInterrupt, including the simulator's own probes of
+// the firmware either side of the ISR
+static bool Servicing;
+static uint32_t IsrDelayCycles;
+static uint64_t MainlineCalls;
+static uint64_t MainlineCycles;
+static uint64_t MainlineRemaining;
+static const void *MainlineSite;
+// The site and length of the last cycles mainline was charged, and whether
+// any since the last checkpoint were from somewhere else or of another length
+static const void *PassSite;
+static uint64_t PassCycles;
+static bool PassesDiffer;
+static jmp_buf EndOfRun;
+
+/*
+  Fast-forward checkpoints, taken each time WakeTimer crosses a window
+*/
+typedef struct
+{
+  uint64_t Cycles;
+  uint64_t TimePs;
+  uint64_t SleepPs;
+  uint64_t SleepCount;
+  uint64_t IdleSleepPs;
+  uint64_t IdleSleepCount;
+  uint64_t WatchdogWakes;
+  uint64_t IsrCount;
+  uint64_t Tmr0Count;
+  uint64_t IocCount;
+  uint64_t IsrCycles;
+  uint64_t DispatchCycles;
+  uint64_t IsrHistogram[ISR_HISTOGRAM_SIZE];
+  uint64_t MainlineCalls;
+  uint64_t MainlineCycles;
+  uint64_t LEDOnPs[LED_COUNT];
+  uint64_t LitPs[LED_COUNT + 1];
+  uint64_t MainlineRemaining;
+  const void *MainlineSite;
+  uint64_t PassCycles;
+  bool PassesDiffer;
+  uint32_t PsRemainder;
+  uint64_t Tmr0Left;
+  uint64_t Tmr2Count;
+  uint64_t Tmr2Left;
+  uint64_t TickCount;
+  uint64_t TickAgePs;
+  uint64_t FlagAge[FW_SOURCE_COUNT];
+  uint32_t WorstLatency[FW_SOURCE_COUNT];
+  uint8_t OutputPins;
+  uint8_t PwmPins;
+  uint32_t PwmOn[LED_COUNT];
+  uint32_t PwmLit[PWM_MODULES + 1];
+  uint8_t IOCFlags;
+  bool ButtonDown;
+  FwState_t Fw;
+} Checkpoint_t;
+
+// Longest repeat, in windows, that fast-forward looks for. The PWM frames that
+// TMR0 times only line up with Timer2's millisecond ticks again every 1024ms
+// at 16MHz, or 4096ms on the idle clock, so nothing repeats in less than that.
+// This reaches it with windows of 16ms or more, if they are a power of 2 ms.
+#define FAST_MAX_PERIOD       256
+#define FAST_SLOTS            (2 * FAST_MAX_PERIOD + 1)
+
+// The last CheckpointCount checkpoints, the latest at CheckpointLatest and
+// the ones before it going back round the ring
+static Checkpoint_t Checkpoints[FAST_SLOTS];
+static uint64_t CheckpointKeys[FAST_SLOTS];
+static int CheckpointCount;
+static int CheckpointLatest;
+static uint32_t LastWakeTimer;
+static uint64_t FastPs;
+static uint64_t FastCount;
+
+/*
+  Statistics
+*/
+static uint64_t SleepPs;
+static uint64_t SleepCount;
+static uint64_t IdleSleepPs;
+static uint64_t IdleSleepCount;
+static uint64_t WatchdogWakes;
+static uint64_t IsrCount;
+static uint64_t Tmr0Count;
+static uint64_t Tmr2Count;
+static uint64_t IocCount;
+static uint64_t IsrCycles;
+static uint64_t DispatchCycles;
+static uint32_t IsrBestCycles = UINT32_MAX;
+static uint32_t IsrWorstCycles;
+static uint64_t IsrHistogram[ISR_HISTOGRAM_SIZE];
+static uint8_t OutputPins;
+static uint64_t OutputSamplePs;
+static uint64_t LEDOnPs[LED_COUNT];
+static uint64_t LitPs[LED_COUNT + 1];
+static int PeakLit;
+static uint64_t WindowStartPs;
+static uint64_t WindowEndPs;
+static uint64_t WindowOnPs[LED_COUNT];
+static int LastWindowDuty[LED_COUNT];
+static uint64_t TickCount;
+static uint64_t LastTickPs;
+static bool TickSeen;
+static uint64_t TickGapMinPs = UINT64_MAX;
+static uint64_t TickGapMaxPs;
+static uint32_t WorstLatency[FW_SOURCE_COUNT];
+
+static void Usage(const char *Name)
+{
+  printf(
+    "Usage: %s [options]\n"
+    "  -t, --time MS            simulated run time (default 10000)\n"
+    "  -p, --press MS[:HOLD]    press the button at MS for HOLD ms (default 100),\n"
+    "                           may be given more than once\n"
+    "  -b, --bounce N           add N bounce pulses to every button transition\n"
+    "  -l, --loop-cycles N      cycles charged per mainline PORTA read or NOP\n"
+    "                           (default %u)\n"
+    "  -i, --isr-cycles N       charge N cycles per interrupt instead of using\n"
+    "                           the cost model\n"
+    "  -L, --isr-latency N      cycles from interrupt to TMR0 reload instead of\n"
+    "                           using the cost model\n"
+    "  -v, --trace              print LED duty whenever it changes\n"
+    "  -w, --window MS          LED duty trace window (default %u)\n"
+    "  -f, --fast               skip ahead through periods where nothing changes\n"
+    "  -F, --fast-window MS     fast-forward checkpoint spacing (default %u), a\n"
+    "                           power of 2 so that it lines up with the PWM\n"
+    "                           frames\n"
+    "  -c, --led-current MA     current drawn by one lit LED (default %u)\n"
+    "  -r, --run-current UA     PIC current running at 16MHz (default %u)\n"
+    "  -k, --static-current UA  part of the run current that does not scale\n"
+    "                           with the clock (default %u)\n"
+    "  -s, --sleep-current UA   PIC current asleep (default %u)\n",
+    Name, Options.LoopCycles, Options.TraceWindowMs, Options.FastWindowMs,
+    Options.LEDMilliamps, Options.RunMicroamps, Options.StaticMicroamps,
+    Options.SleepMicroamps);
+#ifdef SIM_STRESS
+  printf(
+    "  -P, --preempt-every N    interrupt mainline at every Nth point it could\n"
+    "                           be interrupted at (default %u)\n",
+    Options.PreemptEvery);
+#endif
+}
+
+static double ToMs(uint64_t Ps)
+{
+  return (double)Ps / (double)PS_PER_MS;
+}
+
+// Time Count instruction cycles take with an oscillator of Hz
+static double CyclesPs(uint64_t Count, uint64_t Hz)
+{
+  return (double)Count * 4.0 * 1000.0 * PS_PER_MS / (double)Hz;
+}
+
+// Instruction clock source selected by OSCCON (INTOSC only)
+static uint32_t OscillatorHz(void)
+{
+  static const uint32_t IRCFHz[16] = {
+    31000, 31000, 31250, 31250, 62500, 125000, 250000, 500000,
+    125000, 250000, 500000, 1000000, 2000000, 4000000, 8000000, 16000000
+  };
+
+  if (OSCCONbits.SPLLEN && (OSCCONbits.IRCF == 0x0E))
+  {
+    return 32000000;
+  }
+  return IRCFHz[OSCCONbits.IRCF];
+}
+
+static void PowerOnReset(void)
+{
+  INTCON = 0x00;
+  STATUS = 0x18;
+  OPTION_REG = 0xFF;
+  TMR0 = 0x00;
+  PIR1 = 0x00;
+  PIE1 = 0x00;
+  T2CON = 0x00;
+  TMR2 = 0x00;
+  PR2 = 0xFF;
+  LATA = 0x00;
+  TRISA = 0x3F;
+  ANSELA = 0x17;
+  WPUA = 0x3F;
+  ODCONA = 0x00;
+  APFCON = 0x00;
+  IOCAP = 0x00;
+  IOCAN = 0x00;
+  IOCAF = 0x00;
+  OSCCON = 0x38;
+  OSCTUNE = 0x00;
+  BORCON = 0x00;
+  WDTCON = 0x16;
+  VREGCON = 0x01;
+  Tmr0Shadow = TMR0;
+  Tmr2Shadow = TMR2;
+  T2ConShadow = T2CON;
+}
+
+/*
+  LED output bookkeeping
+*/
+static void PrintWindow(void)
+{
+  uint64_t WindowPs = OutputSamplePs - WindowStartPs;
+  int Duty[LED_COUNT];
+  bool Changed = false;
+  int i;
+
+  if (WindowPs == 0)
+  {
+    return;
+  }
+  for (i = 0; i < LED_COUNT; i++)
+  {
+    Duty[i] = (int)((WindowOnPs[i] * 1000 + WindowPs / 2) / WindowPs);
+    Changed |= (Duty[i] != LastWindowDuty[i]);
+    LastWindowDuty[i] = Duty[i];
+    WindowOnPs[i] = 0;
+  }
+  WindowStartPs = OutputSamplePs;
+  if (Changed)
+  {
+    printf("%12.3f ms  LED", ToMs(OutputSamplePs));
+    for (i = 0; i < LED_COUNT; i++)
+    {
+      printf("  D%d %5.1f%%", i + 1, Duty[i] / 10.0);
+    }
+    printf("\n");
+  }
+}
+
+// Credit the LEDs that are currently lit with the time up to Ps
+// How much of Ps picoseconds LED i was on for with the outputs as they are
+static uint64_t LEDOnTime(int i, uint64_t Ps)
+{
+  if (PwmPins & LEDPins[i])
+  {
+    if ((PwmOn[i] == 0) || (PwmOn[i] == PwmPeriod[i]))
+    {
+      return PwmOn[i] ? Ps : 0;
+    }
+    return (uint64_t)((unsigned __int128)Ps * PwmOn[i] / PwmPeriod[i]);
+  }
+  return (OutputPins & LEDPins[i]) ? Ps : 0;
+}
+
+// Credit Ps picoseconds of the board being on to the number of LEDs lit at once
+static void AccumulateLit(uint64_t Ps)
+{
+  int Lit = __builtin_popcount(OutputPins & (uint8_t)~PwmPins & LED_PINS);
+  uint64_t Done = 0;
+  uint64_t Part;
+  uint32_t Sum = 0;
+
+  if ((Asleep && !IdleSleep) || (Ps == 0))
+  {
+    return;
+  }
+  if (!PwmLitPeriod)
+  {
+    LitPs[Lit] += Ps;
+    PeakLit = (Lit > PeakLit) ? Lit : PeakLit;
+    return;
+  }
+  // The software driven LEDs are lit alongside every part of the PWM period
+  for (size_t k = 0; k <= PWM_MODULES; k++)
+  {
+    if (PwmLit[k])
+    {
+      Sum += PwmLit[k];
+      Part = (uint64_t)((unsigned __int128)Ps * Sum / PwmLitPeriod) - Done;
+      LitPs[Lit + k] += Part;
+      Done += Part;
+      PeakLit = (Lit + (int)k > PeakLit) ? Lit + (int)k : PeakLit;
+    }
+  }
+}
+
+static void AccumulateOutputs(uint64_t Ps)
+{
+  uint64_t On;
+
+  while (Options.Trace && (Ps >= WindowEndPs))
+  {
+    for (int i = 0; i < LED_COUNT; i++)
+    {
+      On = LEDOnTime(i, WindowEndPs - OutputSamplePs);
+      WindowOnPs[i] += On;
+      LEDOnPs[i] += On;
+    }
+    AccumulateLit(WindowEndPs - OutputSamplePs);
+    OutputSamplePs = WindowEndPs;
+    PrintWindow();
+    WindowEndPs += Options.TraceWindowMs * PS_PER_MS;
+  }
+  for (int i = 0; i < LED_COUNT; i++)
+  {
+    On = LEDOnTime(i, Ps - OutputSamplePs);
+    WindowOnPs[i] += On;
+    LEDOnPs[i] += On;
+  }
+  AccumulateLit(Ps - OutputSamplePs);
+  OutputSamplePs = Ps;
+}
+
+// Work out how much of the PWM period each number of PWM driven LEDs is lit for
+static void CountPwmLit(void)
+{
+  uint32_t Points[2 * PWM_MODULES + 2];
+  size_t Count = 0;
+  size_t i;
+  size_t j;
+
+  memset(PwmLit, 0, sizeof(PwmLit));
+  PwmLitPeriod = 0;
+  for (size_t m = 0; m < PWM_MODULES; m++)
+  {
+    if (PwmModules[m].Driving && !PwmLitPeriod)
+    {
+      PwmLitPeriod = (uint32_t)PwmModules[m].Period + 1;
+      Points[Count++] = 0;
+      Points[Count++] = PwmLitPeriod;
+    }
+    if (PwmModules[m].Driving)
+    {
+      Points[Count++] = PwmModules[m].Start;
+      Points[Count++] = PwmModules[m].End;
+    }
+  }
+
+  // Sort the edges, then count the modules lit between each pair of them
+  for (i = 1; i < Count; i++)
+  {
+    uint32_t Point = Points[i];
+
+    for (j = i; (j > 0) && (Points[j - 1] > Point); j--)
+    {
+      Points[j] = Points[j - 1];
+    }
+    Points[j] = Point;
+  }
+  for (i = 0; (i + 1 < Count) && (Points[i] < PwmLitPeriod); i++)
+  {
+    uint32_t End = (Points[i + 1] < PwmLitPeriod) ? Points[i + 1] : PwmLitPeriod;
+    int Lit = 0;
+
+    for (size_t m = 0; m < PWM_MODULES; m++)
+    {
+      const PwmModule_t *Module = &PwmModules[m];
+
+      Lit += Module->Driving &&
+             (((Points[i] >= Module->Start) && (Points[i] < Module->End)) != Module->Inverted);
+    }
+    PwmLit[Lit] += End - Points[i];
+  }
+}
+
+// Load any PWM buffers the firmware has asked for, and work out which pins the
+// modules are driving and at what duty
+static void SamplePwm(void)
+{
+  static uint8_t LastCon[PWM_MODULES];
+  static uint8_t LastTRISA;
+  static uint8_t LastAPFCON;
+  bool Changed = (TRISA != LastTRISA) || (APFCON != LastAPFCON);
+
+  // Nothing to do unless a PWM or the pins it drives have been touched
+  for (size_t m = 0; m < PWM_MODULES; m++)
+  {
+    Changed |= (*PwmModules[m].Con != LastCon[m]) || (*PwmModules[m].LdCon & PWMLDCON_LDA);
+    LastCon[m] = *PwmModules[m].Con;
+  }
+  if (!Changed)
+  {
+    return;
+  }
+  LastTRISA = TRISA;
+  LastAPFCON = APFCON;
+
+  PwmPins = 0;
+  for (size_t m = 0; m < PWM_MODULES; m++)
+  {
+    PwmModule_t *Module = &PwmModules[m];
+    uint8_t Pin = (APFCON & Module->Select) ? Module->AltPin : Module->Pin;
+    uint32_t Period;
+    uint32_t On = 0;
+
+    if (*Module->LdCon & PWMLDCON_LDA)
+    {
+      Module->Phase = *Module->Ph;
+      Module->Duty = *Module->Dc;
+      Module->Period = *Module->Pr;
+      *Module->LdCon &= (uint8_t)~PWMLDCON_LDA;
+    }
+    Module->Driving = (*Module->Con & PWMCON_OE) && !(TRISA & Pin);
+    if (!Module->Driving)
+    {
+      continue;
+    }
+    // Standard mode: active from the phase count up to the duty cycle count
+    Period = (uint32_t)Module->Period + 1;
+    Module->Start = 0;
+    Module->End = 0;
+    if ((*Module->Con & PWMCON_EN) && (Module->Duty > Module->Phase))
+    {
+      Module->Start = Module->Phase;
+      Module->End = (Module->Duty < Period) ? Module->Duty : Period;
+      On = Module->End - Module->Start;
+    }
+    Module->Inverted = (*Module->Con & PWMCON_POL) != 0;
+    if (Module->Inverted)
+    {
+      On = Period - On;
+    }
+    PwmPins |= Pin;
+    PwmOn[PinLED[__builtin_ctz(Pin)]] = On;
+    PwmPeriod[PinLED[__builtin_ctz(Pin)]] = Period;
+  }
+  CountPwmLit();
+}
+
+// Pick up whatever the firmware has just written to LATA/TRISA or the PWMs
+static void SampleOutputs(void)
+{
+  OutputPins = LATA & (uint8_t)~TRISA;
+  SamplePwm();
+}
+
+/*
+  Button input
+*/
+static void SetButton(bool Pressed)
+{
+  if (Pressed == ButtonDown)
+  {
+    return;
+  }
+  ButtonDown = Pressed;
+  if (Pressed ? IOCANbits.IOCAN3 : IOCAPbits.IOCAP3)
+  {
+    if (IOCAF == 0)
+    {
+      FlagCycles[FW_SOURCE_IOC] = Cycles;
+    }
+    IOCAFbits.IOCAF3 = 1;
+  }
+}
+
+static void ApplyInputEvents(void)
+{
+  while ((NextInputEvent < InputEventCount) &&
+         (InputEvents[NextInputEvent].TimePs <= TimePs))
+  {
+    if (Options.Trace)
+    {
+      printf("%12.3f ms  button %s\n", ToMs(InputEvents[NextInputEvent].TimePs),
+             InputEvents[NextInputEvent].Pressed ? "down" : "up");
+    }
+    SetButton(InputEvents[NextInputEvent].Pressed);
+    NextInputEvent++;
+  }
+}
+
+static void AddInputEvent(uint64_t Ps, bool Pressed)
+{
+  InputEvents = realloc(InputEvents, (InputEventCount + 1) * sizeof(*InputEvents));
+  InputEvents[InputEventCount].TimePs = Ps;
+  InputEvents[InputEventCount].Pressed = Pressed;
+  InputEventCount++;
+}
+
+static void AddTransition(uint64_t Ps, bool Pressed)
+{
+  for (uint32_t i = 0; i < Options.BounceEdges; i++)
+  {
+    AddInputEvent(Ps, Pressed);
+    AddInputEvent(Ps + BOUNCE_PS, !Pressed);
+    Ps += 2 * BOUNCE_PS;
+  }
+  AddInputEvent(Ps, Pressed);
+}
+
+static int CompareInputEvents(const void *A, const void *B)
+{
+  const InputEvent_t *EA = A;
+  const InputEvent_t *EB = B;
+
+  return (EA->TimePs > EB->TimePs) - (EA->TimePs < EB->TimePs);
+}
+
+/*
+  Timer0
+*/
+static uint32_t Tmr0Prescale(void)
+{
+  return OPTION_REGbits.PSA ? 1 : (2u << OPTION_REGbits.PS);
+}
+
+// A write to TMR0 clears the prescaler
+static void CheckTmr0Write(void)
+{
+  if (TMR0 != Tmr0Shadow)
+  {
+    Tmr0PrescaleCount = 0;
+    Tmr0Shadow = TMR0;
+  }
+}
+
+static uint64_t CyclesToTmr0Overflow(void)
+{
+  if (OPTION_REGbits.TMR0CS)
+  {
+    return UINT64_MAX;
+  }
+  return (uint64_t)(256 - TMR0) * Tmr0Prescale() - Tmr0PrescaleCount;
+}
+
+static void RunTmr0(uint64_t Count)
+{
+  uint64_t Total;
+  uint64_t Value;
+
+  if (OPTION_REGbits.TMR0CS)
+  {
+    return;
+  }
+  Total = Tmr0PrescaleCount + Count;
+  Tmr0PrescaleCount = (uint32_t)(Total % Tmr0Prescale());
+  Value = TMR0 + Total / Tmr0Prescale();
+  if (Value > 0xFF)
+  {
+    INTCONbits.TMR0IF = 1;
+  }
+  TMR0 = (uint8_t)Value;
+  Tmr0Shadow = TMR0;
+}
+
+/*
+  Timer2
+*/
+static uint32_t Tmr2Prescale(void)
+{
+  static const uint32_t Prescale[4] = {1, 4, 16, 64};
+
+  return Prescale[T2CONbits.T2CKPS];
+}
+
+// A write to TMR2 or T2CON clears the prescaler and postscaler
+static void CheckTmr2Write(void)
+{
+  if ((TMR2 != Tmr2Shadow) || (T2CON != T2ConShadow))
+  {
+    Tmr2PrescaleCount = 0;
+    Tmr2PostscaleCount = 0;
+    Tmr2Shadow = TMR2;
+    T2ConShadow = T2CON;
+  }
+}
+
+// Counts from TMR2 as it is to the count that matches PR2 and resets it
+static uint32_t Tmr2CountsToReset(void)
+{
+  return (TMR2 <= PR2) ? (uint32_t)(PR2 - TMR2 + 1) : (uint32_t)(256 - TMR2 + PR2 + 1);
+}
+
+static uint64_t CyclesToTmr2Interrupt(void)
+{
+  uint64_t Resets;
+
+  if (!T2CONbits.TMR2ON)
+  {
+    return UINT64_MAX;
+  }
+  Resets = T2CONbits.T2OUTPS + 1 - Tmr2PostscaleCount;
+  return ((uint64_t)Tmr2CountsToReset() + (Resets - 1) * (PR2 + 1)) * Tmr2Prescale() -
+         Tmr2PrescaleCount;
+}
+
+static void RunTmr2(uint64_t Count)
+{
+  uint64_t Total;
+  uint64_t Counts;
+  uint64_t Resets;
+  uint32_t ToReset;
+
+  if (!T2CONbits.TMR2ON)
+  {
+    return;
+  }
+  Total = Tmr2PrescaleCount + Count;
+  Tmr2PrescaleCount = (uint32_t)(Total % Tmr2Prescale());
+  Counts = Total / Tmr2Prescale();
+  ToReset = Tmr2CountsToReset();
+  if (Counts < ToReset)
+  {
+    TMR2 = (uint8_t)(TMR2 + Counts);
+  }
+  else
+  {
+    Counts -= ToReset;
+    Resets = 1 + Counts / (PR2 + 1);
+    TMR2 = (uint8_t)(Counts % (PR2 + 1));
+    Resets += Tmr2PostscaleCount;
+    if (Resets >= T2CONbits.T2OUTPS + 1u)
+    {
+      PIR1bits.TMR2IF = 1;
+    }
+    Tmr2PostscaleCount = (uint32_t)(Resets % (T2CONbits.T2OUTPS + 1u));
+  }
+  Tmr2Shadow = TMR2;
+}
+
+/*
+  Core scheduler
+*/
+static void AdvanceTime(uint64_t Ps)
+{
+  AccumulateOutputs(TimePs + Ps);
+  TimePs += Ps;
+}
+
+static void EndRunIfDue(void)
+{
+  if (TimePs >= Options.EndPs)
+  {
+    longjmp(EndOfRun, 1);
+  }
+}
+
+static bool SourcePending(int Source)
+{
+  switch (Source)
+  {
+    case FW_SOURCE_TMR0:
+      return INTCONbits.TMR0IF;
+    case FW_SOURCE_IOC:
+      return IOCAF != 0;
+    default:
+      return PIR1bits.TMR2IF;
+  }
+}
+
+// Note when a timer about to run for Count cycles will set its flag
+static void FlagEdges(uint64_t Count)
+{
+  uint64_t ToFlag;
+
+  ToFlag = CyclesToTmr0Overflow();
+  if (!INTCONbits.TMR0IF && (ToFlag <= Count))
+  {
+    FlagCycles[FW_SOURCE_TMR0] = Cycles + ToFlag;
+  }
+  ToFlag = CyclesToTmr2Interrupt();
+  if (!PIR1bits.TMR2IF && (ToFlag <= Count))
+  {
+    FlagCycles[FW_SOURCE_TMR2] = Cycles + ToFlag;
+  }
+}
+
+// Execute Count instruction cycles with every peripheral running
+static void Elapse(uint64_t Count)
+{
+  unsigned __int128 Total;
+  uint32_t Hz = OscillatorHz();
+
+  CheckTmr0Write();
+  CheckTmr2Write();
+  FlagEdges(Count);
+  RunTmr0(Count);
+  RunTmr2(Count);
+  Cycles += Count;
+  Total = (unsigned __int128)Count * 4000000000000ULL + PsRemainder;
+  PsRemainder = (uint32_t)(Total % Hz);
+  AdvanceTime((uint64_t)(Total / Hz));
+  ApplyInputEvents();
+}
+
+static void UpdateIOCFlag(void)
+{
+  INTCONbits.IOCIF = (IOCAF != 0);
+}
+
+static bool InterruptPending(void)
+{
+  UpdateIOCFlag();
+  return INTCONbits.GIE &&
+         ((INTCONbits.TMR0IE && INTCONbits.TMR0IF) ||
+          (INTCONbits.IOCIE && INTCONbits.IOCIF) ||
+          (INTCONbits.PEIE && PIE1bits.TMR2IE && PIR1bits.TMR2IF));
+}
+
+/*
+  Fast-forward
+*/
+static void TakeCheckpoint(Checkpoint_t *Cp)
+{
+  Cp->Cycles = Cycles;
+  Cp->TimePs = TimePs;
+  Cp->SleepPs = SleepPs;
+  Cp->SleepCount = SleepCount;
+  Cp->IdleSleepPs = IdleSleepPs;
+  Cp->IdleSleepCount = IdleSleepCount;
+  Cp->WatchdogWakes = WatchdogWakes;
+  Cp->IsrCount = IsrCount;
+  Cp->Tmr0Count = Tmr0Count;
+  Cp->IocCount = IocCount;
+  Cp->IsrCycles = IsrCycles;
+  Cp->DispatchCycles = DispatchCycles;
+  memcpy(Cp->IsrHistogram, IsrHistogram, sizeof(IsrHistogram));
+  Cp->MainlineCalls = MainlineCalls;
+  Cp->MainlineCycles = MainlineCycles;
+  memcpy(Cp->LEDOnPs, LEDOnPs, sizeof(LEDOnPs));
+  memcpy(Cp->LitPs, LitPs, sizeof(LitPs));
+  Cp->MainlineRemaining = MainlineRemaining;
+  Cp->MainlineSite = MainlineSite;
+  Cp->PassCycles = PassCycles;
+  Cp->PassesDiffer = PassesDiffer;
+  Cp->PsRemainder = PsRemainder;
+  Cp->Tmr0Left = CyclesToTmr0Overflow();
+  Cp->Tmr2Count = Tmr2Count;
+  Cp->Tmr2Left = CyclesToTmr2Interrupt();
+  Cp->TickCount = TickCount;
+  Cp->TickAgePs = TimePs - LastTickPs;
+  for (int i = 0; i < FW_SOURCE_COUNT; i++)
+  {
+    Cp->FlagAge[i] = SourcePending(i) ? Cycles - FlagCycles[i] : 0;
+    Cp->WorstLatency[i] = WorstLatency[i];
+  }
+  Cp->OutputPins = OutputPins;
+  Cp->PwmPins = PwmPins;
+  memcpy(Cp->PwmOn, PwmOn, sizeof(PwmOn));
+  memcpy(Cp->PwmLit, PwmLit, sizeof(PwmLit));
+  Cp->IOCFlags = IOCAF;
+  Cp->ButtonDown = ButtonDown;
+  FW_GetState(&Cp->Fw);
+}
+
+#define SAME_DELTA(A, B, C, Field)  (((B)->Field - (A)->Field) == ((C)->Field - (B)->Field))
+#define SAME_VALUE(A, B, C, Field)  (((A)->Field == (B)->Field) && ((B)->Field == (C)->Field))
+
+// True if a timer, Left cycles from its interrupt at each checkpoint, is in
+// the same place each time, or came the same way closer to its interrupt
+// without reaching it. The timers stop in SLEEP, so spans of sleeps and short
+// wakes leave them a little further on each time. FastForward stops short
+// of the interrupt.
+static bool TimerRepeats(const Checkpoint_t *A, const Checkpoint_t *B, const Checkpoint_t *C,
+                         uint64_t ALeft, uint64_t BLeft, uint64_t CLeft)
+{
+  if ((ALeft == BLeft) && (BLeft == CLeft))
+  {
+    return true;
+  }
+  // Counting every cycle of the span, so it cannot have come round
+  return (ALeft - BLeft == B->Cycles - A->Cycles) && (BLeft - CLeft == C->Cycles - B->Cycles) &&
+         (ALeft > BLeft) && (BLeft > CLeft);
+}
+
+// How many more spans like the one from B to C a timer, Left cycles from its
+// interrupt at each, can run without reaching it
+static uint64_t TimerSpans(uint64_t BLeft, uint64_t CLeft)
+{
+  return (BLeft == CLeft) ? UINT64_MAX : (CLeft - 1) / (BLeft - CLeft);
+}
+
+// True if the span from A to B played out exactly like the one from B to C
+static bool SpansRepeat(const Checkpoint_t *A, const Checkpoint_t *B, const Checkpoint_t *C,
+                        uint32_t Ms)
+{
+  int i;
+
+  if (!SAME_DELTA(A, B, C, Cycles) || !SAME_DELTA(A, B, C, TimePs) ||
+      !SAME_DELTA(A, B, C, IsrCount) || !SAME_DELTA(A, B, C, Tmr0Count) ||
+      !SAME_DELTA(A, B, C, IocCount) || !SAME_DELTA(A, B, C, MainlineCycles) ||
+      !SAME_DELTA(A, B, C, IsrCycles) || !SAME_DELTA(A, B, C, DispatchCycles) ||
+      !SAME_DELTA(A, B, C, Tmr2Count) || !SAME_DELTA(A, B, C, TickCount) ||
+      !SAME_DELTA(A, B, C, SleepPs) || !SAME_DELTA(A, B, C, SleepCount) ||
+      !SAME_DELTA(A, B, C, IdleSleepPs) || !SAME_DELTA(A, B, C, IdleSleepCount) ||
+      !SAME_DELTA(A, B, C, WatchdogWakes))
+  {
+    return false;
+  }
+  for (i = 0; i < ISR_HISTOGRAM_SIZE; i++)
+  {
+    if (!SAME_DELTA(A, B, C, IsrHistogram[i]))
+    {
+      return false;
+    }
+  }
+  for (i = 0; i < LED_COUNT; i++)
+  {
+    if (!SAME_DELTA(A, B, C, LEDOnPs[i]) || !SAME_VALUE(A, B, C, PwmOn[i]))
+    {
+      return false;
+    }
+  }
+  for (i = 0; i <= LED_COUNT; i++)
+  {
+    if (!SAME_DELTA(A, B, C, LitPs[i]))
+    {
+      return false;
+    }
+  }
+  for (i = 0; i <= (int)PWM_MODULES; i++)
+  {
+    if (!SAME_VALUE(A, B, C, PwmLit[i]))
+    {
+      return false;
+    }
+  }
+  for (i = 0; i < FW_SOURCE_COUNT; i++)
+  {
+    if (!SAME_VALUE(A, B, C, FlagAge[i]) || !SAME_VALUE(A, B, C, WorstLatency[i]))
+    {
+      return false;
+    }
+  }
+  // A span with a sleep in it starts mainline afresh after the wake, so how
+  // far it is through the cycles it is being charged must be the same each
+  // time. In spans of nothing but the same passes of a wait loop, it drifts
+  // against the timers instead, and FastForward works out where it gets to.
+  if (C->SleepCount != B->SleepCount)
+  {
+    if (!SAME_VALUE(A, B, C, MainlineRemaining) || !SAME_DELTA(A, B, C, MainlineCalls))
+    {
+      return false;
+    }
+  }
+  else if (B->PassesDiffer || C->PassesDiffer || !SAME_VALUE(A, B, C, PassCycles))
+  {
+    return false;
+  }
+  if (!SAME_VALUE(A, B, C, MainlineSite) ||
+      !SAME_VALUE(A, B, C, PsRemainder) ||
+      !TimerRepeats(A, B, C, A->Tmr0Left, B->Tmr0Left, C->Tmr0Left) ||
+      !TimerRepeats(A, B, C, A->Tmr2Left, B->Tmr2Left, C->Tmr2Left) ||
+      !SAME_VALUE(A, B, C, OutputPins) || !SAME_VALUE(A, B, C, PwmPins) ||
+      !SAME_VALUE(A, B, C, IOCFlags) ||
+      !SAME_VALUE(A, B, C, ButtonDown) || !SAME_VALUE(A, B, C, Fw.StableSize) ||
+      !SAME_VALUE(A, B, C, Fw.TimerCount))
+  {
+    return false;
+  }
+  // With no tick in a span, as while the part sleeps, the next one is that
+  // much further off each time
+  if ((C->TickCount == B->TickCount) ? !SAME_DELTA(A, B, C, TickAgePs) :
+                                       !SAME_VALUE(A, B, C, TickAgePs))
+  {
+    return false;
+  }
+  if (memcmp(A->Fw.Stable, B->Fw.Stable, A->Fw.StableSize) ||
+      memcmp(B->Fw.Stable, C->Fw.Stable, B->Fw.StableSize))
+  {
+    return false;
+  }
+  if ((B->Fw.WakeTimer - A->Fw.WakeTimer != Ms) || (C->Fw.WakeTimer - B->Fw.WakeTimer != Ms))
+  {
+    return false;
+  }
+  // Each timer is either idle at zero or counted down by exactly one window
+  for (i = 0; i < A->Fw.TimerCount; i++)
+  {
+    if (A->Fw.Timers[i] == 0)
+    {
+      if (B->Fw.Timers[i] || C->Fw.Timers[i])
+      {
+        return false;
+      }
+    }
+    else if ((B->Fw.Timers[i] + Ms != A->Fw.Timers[i]) ||
+             (C->Fw.Timers[i] + Ms != B->Fw.Timers[i]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The index of the checkpoint Back windows before the latest one
+static int CheckpointBefore(int Back)
+{
+  return (CheckpointLatest + FAST_SLOTS - Back) % FAST_SLOTS;
+}
+
+// A hash of the firmware state SpansRepeat needs to be the same at each of
+// its checkpoints, so most spans can be ruled out without looking at them
+static uint64_t CheckpointKey(const Checkpoint_t *Cp)
+{
+  uint64_t Key = 14695981039346656037ULL;
+
+  for (int i = 0; i < Cp->Fw.StableSize; i++)
+  {
+    Key = (Key ^ Cp->Fw.Stable[i]) * 1099511628211ULL;
+  }
+  Key = (Key ^ Cp->OutputPins ^ ((uint64_t)Cp->PwmPins << 8)) * 1099511628211ULL;
+  return Key;
+}
+
+// Record the state at a window boundary as the latest checkpoint
+static void AddCheckpoint(void)
+{
+  CheckpointLatest = (CheckpointLatest + 1) % FAST_SLOTS;
+  TakeCheckpoint(&Checkpoints[CheckpointLatest]);
+  CheckpointKeys[CheckpointLatest] = CheckpointKey(&Checkpoints[CheckpointLatest]);
+  PassesDiffer = false;
+}
+
+// Replay as many copies of the span from B to C as possible without running them
+static void FastForward(const Checkpoint_t *B, const Checkpoint_t *C, uint32_t SpanMs)
+{
+  uint64_t SpanPs = C->TimePs - B->TimePs;
+  uint64_t Spans = FW_MaxSkipMs() / SpanMs;
+  uint64_t Limit;
+  int i;
+
+  if (NextInputEvent < InputEventCount)
+  {
+    Limit = (InputEvents[NextInputEvent].TimePs - TimePs - 1) / SpanPs;
+    Spans = (Limit < Spans) ? Limit : Spans;
+  }
+  Limit = (Options.EndPs - TimePs - 1) / SpanPs;
+  Spans = (Limit < Spans) ? Limit : Spans;
+  Limit = TimerSpans(B->Tmr0Left, C->Tmr0Left);
+  Spans = (Limit < Spans) ? Limit : Spans;
+  Limit = TimerSpans(B->Tmr2Left, C->Tmr2Left);
+  Spans = (Limit < Spans) ? Limit : Spans;
+  if (Spans == 0)
+  {
+    return;
+  }
+
+  if (Options.Trace)
+  {
+    PrintWindow();
+    printf("%12.3f ms  fast-forward %llu ms\n", ToMs(TimePs),
+           (unsigned long long)(Spans * SpanMs));
+  }
+
+  Cycles += Spans * (C->Cycles - B->Cycles);
+  for (i = 0; i < FW_SOURCE_COUNT; i++)
+  {
+    FlagCycles[i] += Spans * (C->Cycles - B->Cycles);
+  }
+  TimePs += Spans * SpanPs;
+  SleepPs += Spans * (C->SleepPs - B->SleepPs);
+  SleepCount += Spans * (C->SleepCount - B->SleepCount);
+  IdleSleepPs += Spans * (C->IdleSleepPs - B->IdleSleepPs);
+  IdleSleepCount += Spans * (C->IdleSleepCount - B->IdleSleepCount);
+  WatchdogWakes += Spans * (C->WatchdogWakes - B->WatchdogWakes);
+  IsrCount += Spans * (C->IsrCount - B->IsrCount);
+  Tmr0Count += Spans * (C->Tmr0Count - B->Tmr0Count);
+  Tmr2Count += Spans * (C->Tmr2Count - B->Tmr2Count);
+  if (C->TickCount != B->TickCount)
+  {
+    TickCount += Spans * (C->TickCount - B->TickCount);
+    LastTickPs += Spans * SpanPs;
+  }
+  RunTmr0(Spans * (B->Tmr0Left - C->Tmr0Left));
+  RunTmr2(Spans * (B->Tmr2Left - C->Tmr2Left));
+  IocCount += Spans * (C->IocCount - B->IocCount);
+  IsrCycles += Spans * (C->IsrCycles - B->IsrCycles);
+  DispatchCycles += Spans * (C->DispatchCycles - B->DispatchCycles);
+  for (i = 0; i < ISR_HISTOGRAM_SIZE; i++)
+  {
+    IsrHistogram[i] += Spans * (C->IsrHistogram[i] - B->IsrHistogram[i]);
+  }
+  MainlineCycles += Spans * (C->MainlineCycles - B->MainlineCycles);
+  if (C->SleepCount != B->SleepCount)
+  {
+    MainlineCalls += Spans * (C->MainlineCalls - B->MainlineCalls);
+  }
+  else
+  {
+    // Mainline would have gone on through more of the same passes, ending
+    // as far into the last one as this leaves
+    uint64_t Done = PassCycles - MainlineRemaining + Spans * (C->MainlineCycles - B->MainlineCycles);
+    uint64_t Passes = (Done - 1) / PassCycles;
+
+    MainlineCalls += Passes;
+    MainlineRemaining = PassCycles - (Done - Passes * PassCycles);
+  }
+  for (i = 0; i < LED_COUNT; i++)
+  {
+    LEDOnPs[i] += Spans * (C->LEDOnPs[i] - B->LEDOnPs[i]);
+  }
+  for (i = 0; i <= LED_COUNT; i++)
+  {
+    LitPs[i] += Spans * (C->LitPs[i] - B->LitPs[i]);
+  }
+  FW_Skip((uint32_t)(Spans * SpanMs));
+
+  OutputSamplePs = TimePs;
+  WindowStartPs = TimePs;
+  WindowEndPs = TimePs + Options.TraceWindowMs * PS_PER_MS;
+  FastPs += Spans * SpanPs;
+  FastCount++;
+
+  LastWakeTimer = FW_WakeTimer();
+  AddCheckpoint();
+  CheckpointCount = 1;
+}
+
+// Called after every interrupt and as mainline starts each pass, which is
+// the first chance after a sleep: checkpoint each window boundary
+static void CheckFastForward(void)
+{
+  uint32_t WakeTimer;
+
+  // Leave the firmware alone otherwise, as this runs in mainline too
+  if (!Options.Fast)
+  {
+    return;
+  }
+  WakeTimer = FW_WakeTimer();
+
+  // The firmware may count several milliseconds in one interrupt, so look for
+  // WakeTimer moving into a new window rather than landing on its start
+  if (WakeTimer / Options.FastWindowMs == LastWakeTimer / Options.FastWindowMs)
+  {
+    LastWakeTimer = WakeTimer;
+    return;
+  }
+  LastWakeTimer = WakeTimer;
+  AddCheckpoint();
+  if (CheckpointCount < FAST_SLOTS)
+  {
+    CheckpointCount++;
+  }
+
+  // Look for the shortest span that has just repeated itself
+  for (int Period = 1; 2 * Period < CheckpointCount; Period++)
+  {
+    const Checkpoint_t *C = &Checkpoints[CheckpointLatest];
+    int BAt = CheckpointBefore(Period);
+    int AAt = CheckpointBefore(2 * Period);
+    const Checkpoint_t *B = &Checkpoints[BAt];
+    const Checkpoint_t *A = &Checkpoints[AAt];
+    uint32_t SpanMs = C->Fw.WakeTimer - B->Fw.WakeTimer;
+
+    if ((CheckpointKeys[AAt] != CheckpointKeys[CheckpointLatest]) ||
+        (CheckpointKeys[BAt] != CheckpointKeys[CheckpointLatest]))
+    {
+      continue;
+    }
+
+    if (SpansRepeat(A, B, C, SpanMs))
+    {
+      FastForward(B, C, SpanMs);
+      break;
+    }
+  }
+}
+
+static void RecordInterruptCost(uint32_t Count)
+{
+  IsrCycles += Count;
+  IsrBestCycles = (Count < IsrBestCycles) ? Count : IsrBestCycles;
+  IsrWorstCycles = (Count > IsrWorstCycles) ? Count : IsrWorstCycles;
+  IsrHistogram[(Count < ISR_HISTOGRAM_SIZE) ? Count : ISR_HISTOGRAM_SIZE - 1]++;
+}
+
+// Worst time from each source's flag being set to INTERRUPT_InterruptManager
+// getting to it, for the interrupt that started at StartCycles
+static void RecordLatency(uint64_t StartCycles)
+{
+  for (int i = 0; i < FW_SOURCE_COUNT; i++)
+  {
+    uint64_t ServiceCycles = StartCycles + FW_ServiceCycles(i);
+    uint32_t Latency;
+
+    if (FW_ServiceCycles(i) == 0)
+    {
+      continue;
+    }
+    // A flag set after its test was passed counts as no wait at all
+    Latency = (ServiceCycles > FlagCycles[i]) ? (uint32_t)(ServiceCycles - FlagCycles[i]) : 0;
+    WorstLatency[i] = (Latency > WorstLatency[i]) ? Latency : WorstLatency[i];
+  }
+}
+
+// The firmware has counted Ticks milliseconds in the interrupt that is running
+static void RecordTicks(uint32_t Ticks)
+{
+  uint64_t GapPs;
+
+  // Several ticks counted in one interrupt are no time apart
+  if (Ticks > 1)
+  {
+    TickGapMinPs = 0;
+  }
+  if (TickSeen)
+  {
+    GapPs = TimePs - LastTickPs;
+    TickGapMinPs = (GapPs < TickGapMinPs) ? GapPs : TickGapMinPs;
+    TickGapMaxPs = (GapPs > TickGapMaxPs) ? GapPs : TickGapMaxPs;
+  }
+  TickCount += Ticks;
+  LastTickPs = TimePs;
+  TickSeen = true;
+}
+
+static void RunInterrupt(void)
+{
+  uint32_t Latency = Options.IsrLatencyCycles ? Options.IsrLatencyCycles : FW_ReloadLatencyCycles();
+  uint64_t StartCycles = Cycles;
+  uint32_t Cost;
+  uint32_t Ticks;
+  bool Tmr0Flag;
+  bool Tmr2Flag;
+  uint8_t IOCFlags;
+
+  // The firmware's reload of TMR0 is the only thing whose timing within the
+  // interrupt matters, so the interrupt runs at that point
+  Servicing = true;
+  INTCONbits.GIE = 0;
+  Elapse(Latency);
+
+  UpdateIOCFlag();
+  Tmr0Flag = INTCONbits.TMR0IF;
+  Tmr2Flag = PIR1bits.TMR2IF;
+  IOCFlags = IOCAF;
+  FW_BeforeInterrupt();
+  Ticks = FW_WakeTimer();
+  IsrDelayCycles = 0;
+  InInterrupt = true;
+  INTERRUPT_InterruptManager();
+  InInterrupt = false;
+  Ticks = FW_WakeTimer() - Ticks;
+  if (Ticks)
+  {
+    RecordTicks(Ticks);
+  }
+  Cost = Options.IsrCycles ? Options.IsrCycles : FW_InterruptCycles();
+  if (!Options.IsrCycles)
+  {
+    DispatchCycles += FW_DispatchCycles();
+    RecordLatency(StartCycles);
+  }
+  // Delays inside the ISR have already been run
+  Cost += IsrDelayCycles;
+  Latency += IsrDelayCycles;
+  CheckTmr0Write();
+  SampleOutputs();
+
+  IsrCount++;
+  Tmr0Count += (Tmr0Flag && !INTCONbits.TMR0IF);
+  Tmr2Count += (Tmr2Flag && !PIR1bits.TMR2IF);
+  IocCount += (IOCFlags && (IOCAF != IOCFlags));
+  RecordInterruptCost(Cost);
+
+  if (Cost > Latency)
+  {
+    Elapse(Cost - Latency);
+  }
+  INTCONbits.GIE = 1;
+  CheckFastForward();
+  Servicing = false;
+}
+
+static uint64_t CyclesToNextInput(void)
+{
+  unsigned __int128 Cy;
+
+  if (NextInputEvent >= InputEventCount)
+  {
+    return UINT64_MAX;
+  }
+  Cy = (unsigned __int128)(InputEvents[NextInputEvent].TimePs - TimePs) * OscillatorHz();
+  return (uint64_t)(Cy / 4000000000000ULL) + 1;
+}
+
+// Mainline cycles to the end of the run. Mainline stops there rather than at
+// the end of its pass, as how far through a pass it is isn't kept by --fast.
+static uint64_t CyclesToEnd(void)
+{
+  unsigned __int128 Cy = (unsigned __int128)(Options.EndPs - TimePs) * OscillatorHz();
+
+  return (uint64_t)((Cy + 3999999999999ULL) / 4000000000000ULL);
+}
+
+// Mainline has consumed Count cycles; fire whatever interrupts are due
+static void RunMainline(uint64_t Count)
+{
+  SampleOutputs();
+  MainlineCalls++;
+  if ((MainlineSite != PassSite) || (Count != PassCycles))
+  {
+    PassesDiffer = true;
+    PassSite = MainlineSite;
+    PassCycles = Count;
+  }
+  MainlineRemaining = Count;
+  CheckFastForward();
+  while (1)
+  {
+    uint64_t Step;
+
+    while (InterruptPending())
+    {
+      RunInterrupt();
+      EndRunIfDue();
+    }
+    // A fast-forward from one of those moves mainline on as well
+    Count = MainlineRemaining;
+    if (Count == 0)
+    {
+      break;
+    }
+    Step = Count;
+    if (Step > CyclesToTmr0Overflow())
+    {
+      Step = CyclesToTmr0Overflow();
+    }
+    if (Step > CyclesToTmr2Interrupt())
+    {
+      Step = CyclesToTmr2Interrupt();
+    }
+    if (Step > CyclesToNextInput())
+    {
+      Step = CyclesToNextInput();
+    }
+    if (Step > CyclesToEnd())
+    {
+      Step = CyclesToEnd();
+    }
+    Elapse(Step);
+    MainlineCycles += Step;
+    MainlineRemaining = Count - Step;
+    EndRunIfDue();
+  }
+}
+
+/*
+  Hooks called from the firmware through xc.h
+*/
+// Mainline only uses NOP() in the loop it waits for events in, so each one is
+// charged as a pass of that loop
+void SIM_Nop(void)
+{
+  if (Running && !InInterrupt)
+  {
+    MainlineSite = __builtin_return_address(0);
+    RunMainline(Options.LoopCycles);
+  }
+}
+
+volatile PORTAbits_t *SIM_ReadPORTA(void)
+{
+  uint8_t Inputs = 0;
+
+  if (Running && !InInterrupt)
+  {
+    // Where mainline is, so fast-forward only matches points in the same place
+    MainlineSite = __builtin_return_address(0);
+    RunMainline(Options.LoopCycles);
+  }
+  if (!ButtonDown)
+  {
+    Inputs |= BUTTON_PIN;
+  }
+  // Weak pull-ups hold unused inputs high
+  if (!OPTION_REGbits.nWPUEN)
+  {
+    Inputs |= WPUA & (uint8_t)~BUTTON_PIN;
+  }
+  PortA.reg = (uint8_t)((LATA & ~TRISA) | (Inputs & TRISA));
+  return &PortA;
+}
+
+void SIM_Delay(uint32_t Count)
+{
+  if (InInterrupt)
+  {
+    // A delay inside the ISR is how it times output changes that are too
+    // close together for separate interrupts, so what it has written so far
+    // shows on the pins for the length of the delay. A TMR0 write before it
+    // restarts the count from there.
+    SampleOutputs();
+    CheckTmr0Write();
+    Elapse(Count);
+    IsrDelayCycles += Count;
+    return;
+  }
+  MainlineSite = __builtin_return_address(0);
+  RunMainline(Count);
+}
+
+void SIM_ClearWatchdog(void)
+{
+  STATUSbits.nTO = 1;
+  STATUSbits.nPD = 1;
+}
+
+// An enabled interrupt flag is set, which wakes the part whether or not GIE is
+static bool WakeFlagPending(void)
+{
+  return (INTCONbits.TMR0IE && INTCONbits.TMR0IF) ||
+         (INTCONbits.IOCIE && IOCAF) ||
+         (INTCONbits.PEIE && PIE1bits.TMR2IE && PIR1bits.TMR2IF);
+}
+
+void SIM_Sleep(void)
+{
+  uint64_t StartPs = TimePs;
+  uint64_t WakePs = UINT64_MAX;
+  uint64_t EndPs;
+
+  // SLEEP runs as a NOP, leaving nTO and nPD alone, if a flag is already set
+  if (WakeFlagPending())
+  {
+    return;
+  }
+  STATUSbits.nTO = 1;
+  STATUSbits.nPD = 0;
+  if (WDTCONbits.SWDTEN)
+  {
+    uint32_t Prescale = 32UL << (WDTCONbits.WDTPS < WDTPS_MAX ? WDTCONbits.WDTPS : WDTPS_MAX);
+
+    WakePs = TimePs + Prescale * 1000000000000ULL / LFINTOSC_HZ;
+    IdleSleep = true;
+    IdleSleepCount++;
+  }
+  else
+  {
+    // Only a press ends this sleep, so what went before won't come round again
+    CheckpointCount = 0;
+  }
+
+  SampleOutputs();
+  SleepCount++;
+  TickSeen = false;
+  Asleep = true;
+  if (Options.Trace)
+  {
+    printf("%12.3f ms  sleep%s\n", ToMs(TimePs), IdleSleep ? " (watchdog running)" : "");
+  }
+
+  // The oscillator stops, so only an input edge or the watchdog can wake us up
+  while (!(INTCONbits.IOCIE && IOCAF))
+  {
+    EndPs = Options.EndPs;
+    if ((NextInputEvent < InputEventCount) && (InputEvents[NextInputEvent].TimePs < EndPs))
+    {
+      EndPs = InputEvents[NextInputEvent].TimePs;
+    }
+    if (WakePs <= EndPs)
+    {
+      AdvanceTime(WakePs - TimePs);
+      STATUSbits.nTO = 0;
+      WatchdogWakes++;
+      break;
+    }
+    if (EndPs == Options.EndPs)
+    {
+      SleepPs += Options.EndPs - TimePs;
+      IdleSleepPs += IdleSleep ? Options.EndPs - TimePs : 0;
+      AdvanceTime(Options.EndPs - TimePs);
+      longjmp(EndOfRun, 1);
+    }
+    AdvanceTime(EndPs - TimePs);
+    ApplyInputEvents();
+  }
+  SleepPs += TimePs - StartPs;
+  IdleSleepPs += IdleSleep ? TimePs - StartPs : 0;
+  Asleep = false;
+  IdleSleep = false;
+  if (Options.Trace)
+  {
+    printf("%12.3f ms  wake%s\n", ToMs(TimePs), STATUSbits.nTO ? "" : " (watchdog)");
+  }
+}
+
+#ifdef SIM_STRESS
+/*
+  Interrupt injection for stress.c
+*/
+bool SIM_InMainline(void)
+{
+  return Running && !Servicing;
+}
+
+bool SIM_InInterrupt(void)
+{
+  return InInterrupt;
+}
+
+uint64_t SIM_Interrupts(void)
+{
+  return IsrCount;
+}
+
+void SIM_Preempt(void)
+{
+  if (INTCONbits.TMR0IE && !INTCONbits.TMR0IF)
+  {
+    FlagCycles[FW_SOURCE_TMR0] = Cycles;
+    INTCONbits.TMR0IF = 1;
+  }
+  if (INTCONbits.PEIE && PIE1bits.TMR2IE && !PIR1bits.TMR2IF)
+  {
+    FlagCycles[FW_SOURCE_TMR2] = Cycles;
+    PIR1bits.TMR2IF = 1;
+  }
+  while (InterruptPending())
+  {
+    RunInterrupt();
+    EndRunIfDue();
+  }
+}
+#endif
+
+/*
+  Reporting
+*/
+/* Peak, RMS and mean LED current while the board is on, and how long each
+ * number of LEDs was lit at once. Then the PIC's mean current over the same
+ * time, and what it and the board would have drawn had the PIC stayed awake
+ * at 16MHz through its idle sleeps, as it does waiting for events in a busy
+ * loop. Every instruction cycle costs the same charge above the static
+ * current whatever the clock, so that part follows Cycles.
+ */
+static void ReportCurrent(void)
+{
+  uint64_t OnPs = 0;
+  double Mean = 0.0;
+  double Square = 0.0;
+  double Amps;
+  double Mcu;
+  double Busy;
+  int i;
+
+  for (i = 0; i <= LED_COUNT; i++)
+  {
+    OnPs += LitPs[i];
+  }
+  if (OnPs == 0)
+  {
+    return;
+  }
+  for (i = 0; i <= LED_COUNT; i++)
+  {
+    Amps = (double)i * Options.LEDMilliamps;
+    Mean += Amps * LitPs[i] / OnPs;
+    Square += Amps * Amps * LitPs[i] / OnPs;
+  }
+  printf("LED current         peak %.1f mA, RMS %.2f mA, mean %.2f mA (%u mA per LED)\n",
+         (double)PeakLit * Options.LEDMilliamps, sqrt(Square), Mean, Options.LEDMilliamps);
+  printf("LEDs lit at once   ");
+  for (i = 0; i <= LED_COUNT; i++)
+  {
+    printf("  %d %6.2f%%", i, 100.0 * LitPs[i] / OnPs);
+  }
+  printf("\n");
+
+  Busy = Options.RunMicroamps / 1000.0;
+  Mcu = (Options.StaticMicroamps / 1000.0 * (OnPs - IdleSleepPs) +
+         (Options.RunMicroamps - Options.StaticMicroamps) / 1000.0 * CyclesPs(Cycles, RUN_CURRENT_HZ) +
+         Options.SleepMicroamps / 1000.0 * IdleSleepPs) / OnPs;
+  printf("idle sleep          %12.3f ms in %llu sleeps, %.1f%% of the time on, %llu ended by the watchdog\n",
+         ToMs(IdleSleepPs), (unsigned long long)IdleSleepCount, 100.0 * IdleSleepPs / OnPs,
+         (unsigned long long)WatchdogWakes);
+  printf("PIC current         mean %.3f mA, %.3f mA never sleeping (%u uA at 16MHz, %u uA static, %u uA asleep)\n",
+         Mcu, Busy, Options.RunMicroamps, Options.StaticMicroamps, Options.SleepMicroamps);
+  printf("board current       mean %.3f mA, %.3f mA never sleeping\n", Mean + Mcu, Mean + Busy);
+}
+
+// How far the firmware's millisecond count drifted from the time it was awake,
+// and the shortest and longest time between two ticks
+static void ReportTimebase(double AwakeMs)
+{
+  if ((AwakeMs <= 0) || (TickCount == 0))
+  {
+    return;
+  }
+#ifdef SIM_STRESS
+  // Each interrupt stress.c injects sets TMR2IF, so ticks are counted early
+  printf("millisecond ticks   %12llu, not checked as Timer2 interrupts were injected\n",
+         (unsigned long long)TickCount);
+  return;
+#endif
+  printf("millisecond ticks   %12llu in %.3f ms awake (%+.0f ppm), %.3f to %.3f ms apart\n",
+         (unsigned long long)TickCount, AwakeMs, (TickCount / AwakeMs - 1.0) * 1e6,
+         ToMs(TickGapMinPs == UINT64_MAX ? 0 : TickGapMinPs), ToMs(TickGapMaxPs));
+}
+
+static void Report(double WallSeconds)
+{
+  double AwakeMs = ToMs(TimePs - SleepPs);
+
+  printf("simulated time      %12.3f ms (awake %.3f ms, asleep %.3f ms, %llu sleeps)\n",
+         ToMs(TimePs), AwakeMs, ToMs(SleepPs), (unsigned long long)SleepCount);
+  printf("instruction cycles  %12llu, %.3f MHz clock on average awake, %u Hz at the end\n",
+         (unsigned long long)Cycles, AwakeMs > 0 ? Cycles * 4.0 / AwakeMs / 1000.0 : 0.0,
+         OscillatorHz());
+  printf("interrupts          %12llu (TMR0 %llu = %.3f kHz awake, TMR2 %llu, IOC %llu)\n",
+         (unsigned long long)IsrCount, (unsigned long long)Tmr0Count,
+         AwakeMs > 0 ? Tmr0Count / AwakeMs : 0.0, (unsigned long long)Tmr2Count,
+         (unsigned long long)IocCount);
+  if (IsrCount)
+  {
+    uint64_t Typical = 0;
+
+    for (int i = 1; i < ISR_HISTOGRAM_SIZE; i++)
+    {
+      Typical = (IsrHistogram[i] > IsrHistogram[Typical]) ? (uint64_t)i : Typical;
+    }
+    printf("interrupt cycles    best %u, typical %llu, worst %u, mean %.1f%s\n",
+           IsrBestCycles, (unsigned long long)Typical, IsrWorstCycles,
+           (double)IsrCycles / IsrCount, Options.IsrCycles ? " (fixed)" : "");
+  }
+  if (IsrCount && !Options.IsrCycles)
+  {
+    printf("interrupt dispatch  mean %.1f cycles, %.1f%% of awake CPU\n",
+           (double)DispatchCycles / IsrCount, Cycles ? 100.0 * DispatchCycles / Cycles : 0.0);
+    printf("service latency     worst TMR0 %u, IOC %u, TMR2 %u cycles\n",
+           WorstLatency[FW_SOURCE_TMR0], WorstLatency[FW_SOURCE_IOC],
+           WorstLatency[FW_SOURCE_TMR2]);
+  }
+  if (Cycles)
+  {
+    printf("CPU while awake     interrupts %.1f%%, main loop %.1f%%\n",
+           100.0 * IsrCycles / Cycles, 100.0 * (Cycles - IsrCycles) / Cycles);
+  }
+  printf("LED duty           ");
+  for (int i = 0; i < LED_COUNT; i++)
+  {
+    printf("  D%d %6.2f%%", i + 1, TimePs ? 100.0 * LEDOnPs[i] / TimePs : 0.0);
+  }
+  printf("\n");
+  ReportCurrent();
+  ReportTimebase(AwakeMs);
+  if (Options.Fast)
+  {
+    printf("fast-forwarded      %12.3f ms in %llu jumps\n", ToMs(FastPs),
+           (unsigned long long)FastCount);
+  }
+  printf("host time           %12.3f s (%.1fx real time)\n", WallSeconds,
+         WallSeconds > 0 ? ToMs(TimePs) / 1000.0 / WallSeconds : 0.0);
+}
+
+static uint32_t ParseNumber(const char *Text, const char *What)
+{
+  char *End;
+  unsigned long Value = strtoul(Text, &End, 0);
+
+  if ((End == Text) || (*End != '\0' && *End != ':'))
+  {
+    fprintf(stderr, "invalid %s: %s\n", What, Text);
+    exit(2);
+  }
+  return (uint32_t)Value;
+}
+
+int main(int argc, char **argv)
+{
+  static const struct option LongOptions[] = {
+    {"time",        required_argument, NULL, 't'},
+    {"press",       required_argument, NULL, 'p'},
+    {"bounce",      required_argument, NULL, 'b'},
+    {"loop-cycles", required_argument, NULL, 'l'},
+    {"isr-cycles",  required_argument, NULL, 'i'},
+    {"isr-latency", required_argument, NULL, 'L'},
+    {"trace",       no_argument,       NULL, 'v'},
+    {"window",      required_argument, NULL, 'w'},
+    {"fast",        no_argument,       NULL, 'f'},
+    {"fast-window", required_argument, NULL, 'F'},
+    {"led-current", required_argument, NULL, 'c'},
+    {"run-current", required_argument, NULL, 'r'},
+    {"static-current", required_argument, NULL, 'k'},
+    {"sleep-current", required_argument, NULL, 's'},
+#ifdef SIM_STRESS
+    {"preempt-every", required_argument, NULL, 'P'},
+#endif
+    {"help",        no_argument,       NULL, 'h'},
+    {NULL, 0, NULL, 0}
+  };
+  uint32_t *Presses = NULL;
+  size_t PressCount = 0;
+  struct timespec Start, Stop;
+  int Opt;
+
+  while ((Opt = getopt_long(argc, argv, "t:p:b:l:i:L:vw:fF:c:r:k:s:h" STRESS_OPTIONS, LongOptions, NULL)) != -1)
+  {
+    switch (Opt)
+    {
+      case 't':
+        Options.EndPs = ParseNumber(optarg, "time") * PS_PER_MS;
+        break;
+      case 'p':
+        Presses = realloc(Presses, (PressCount + 1) * 2 * sizeof(*Presses));
+        Presses[PressCount * 2] = ParseNumber(optarg, "press time");
+        Presses[PressCount * 2 + 1] = strchr(optarg, ':') ?
+          ParseNumber(strchr(optarg, ':') + 1, "hold time") : 100;
+        PressCount++;
+        break;
+      case 'b':
+        Options.BounceEdges = ParseNumber(optarg, "bounce count");
+        break;
+      case 'l':
+        Options.LoopCycles = ParseNumber(optarg, "loop cycles");
+        break;
+      case 'i':
+        Options.IsrCycles = ParseNumber(optarg, "ISR cycles");
+        break;
+      case 'L':
+        Options.IsrLatencyCycles = ParseNumber(optarg, "ISR latency");
+        break;
+      case 'v':
+        Options.Trace = true;
+        break;
+      case 'w':
+        Options.TraceWindowMs = ParseNumber(optarg, "window");
+        break;
+      case 'f':
+        Options.Fast = true;
+        break;
+      case 'F':
+        Options.FastWindowMs = ParseNumber(optarg, "fast-forward window");
+        break;
+      case 'c':
+        Options.LEDMilliamps = ParseNumber(optarg, "LED current");
+        break;
+      case 'r':
+        Options.RunMicroamps = ParseNumber(optarg, "run current");
+        break;
+      case 'k':
+        Options.StaticMicroamps = ParseNumber(optarg, "static current");
+        break;
+      case 's':
+        Options.SleepMicroamps = ParseNumber(optarg, "sleep current");
+        break;
+#ifdef SIM_STRESS
+      case 'P':
+        Options.PreemptEvery = ParseNumber(optarg, "preempt interval");
+        break;
+#endif
+      case 'h':
+        Usage(argv[0]);
+        return 0;
+      default:
+        Usage(argv[0]);
+        return 2;
+    }
+  }
+  if ((Options.LoopCycles == 0) || (Options.TraceWindowMs == 0) ||
+      (Options.FastWindowMs == 0))
+  {
+    fprintf(stderr, "loop cycles and windows must be non-zero\n");
+    return 2;
+  }
+  if (Options.StaticMicroamps > Options.RunMicroamps)
+  {
+    fprintf(stderr, "static current must not be more than the run current\n");
+    return 2;
+  }
+#ifdef SIM_STRESS
+  // Fast-forward would skip the points the stress test preempts at
+  if (Options.Fast || (Options.PreemptEvery == 0))
+  {
+    fprintf(stderr, "the stress test needs a non-zero interval and no --fast\n");
+    return 2;
+  }
+  STRESS_SetInterval(Options.PreemptEvery);
+#endif
+
+  for (size_t i = 0; i < PressCount; i++)
+  {
+    AddTransition(Presses[i * 2] * PS_PER_MS, true);
+    AddTransition((uint64_t)(Presses[i * 2] + Presses[i * 2 + 1]) * PS_PER_MS, false);
+  }
+  qsort(InputEvents, InputEventCount, sizeof(*InputEvents), CompareInputEvents);
+  free(Presses);
+
+  PowerOnReset();
+  WindowEndPs = Options.TraceWindowMs * PS_PER_MS;
+  memset(LastWindowDuty, 0, sizeof(LastWindowDuty));
+
+  clock_gettime(CLOCK_MONOTONIC, &Start);
+  if (setjmp(EndOfRun) == 0)
+  {
+    Running = true;
+    firmware_main();
+  }
+  Running = false;
+  clock_gettime(CLOCK_MONOTONIC, &Stop);
+
+  Report((Stop.tv_sec - Start.tv_sec) + (Stop.tv_nsec - Start.tv_nsec) / 1e9);
+  free(InputEvents);
+#ifdef SIM_STRESS
+  return STRESS_Report() ? 1 : 0;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,545 @@
+/*
+ * Learn To Solder 2019 host simulator
+ *
+ * Interrupt-injection stress test. See stress.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xc.h"
+#include "firmware.h"
+#include "stress.h"
+
+// Room for the variables in FW_Shared, and for all of their bytes
+#define STRESS_MAX_SHARED     64
+#define STRESS_MAX_BYTES      512
+
+// A store this many mainline accesses or fewer after a load of the same byte
+// is taken to be the end of a read-modify-write of it
+#define STRESS_RMW_WINDOW     4
+
+// Longest load that is compared either side of an interrupt for tearing
+#define STRESS_MAX_LOAD       16
+
+#define STRESS_STR(X)         STRESS_STR2(X)
+#define STRESS_STR2(X)        #X
+
+// Distinct problems kept for the report
+#define STRESS_MAX_FINDINGS   64
+
+// Room for the mainline code sites that access the shared variables, a power
+// of 2
+#define STRESS_MAX_SITES      1024
+
+// Percentage of the sites that are open to interrupts that must have had one
+// injected, for a run without problems to pass
+#define STRESS_MIN_COVERAGE   90
+
+typedef enum
+{
+  FINDING_TORN_READ,
+  FINDING_LOST_UPDATE,
+  FINDING_HALF_FRAME,
+  FINDING_COMMITTED_WRITE,
+  FINDING_SHOWN_WRITE,
+  FINDING_KINDS
+} FindingKind_t;
+
+static const char *const FindingNames[FINDING_KINDS] = {
+  "torn read",
+  "lost update",
+  "half-latched frame",
+  "write after commit",
+  "write while shown",
+};
+
+static const char *const FrameNames[2] = {"LEDFrames[0]", "LEDFrames[1]"};
+
+typedef struct
+{
+  FindingKind_t Kind;
+  const char *Name;           // the variable, or the frame
+  const void *Site;           // the mainline code it was found at
+  uint64_t Count;
+  char Where[200];            // Site as a source line, for the report
+} Finding_t;
+
+static Finding_t Findings[STRESS_MAX_FINDINGS];
+static unsigned FindingCount;
+static bool FindingsDropped;
+
+// A mainline code site that accesses the shared variables. Most only run with
+// GIE clear, in the firmware's critical sections, where no interrupt can come.
+typedef struct
+{
+  const void *Site;
+  bool Open;                  // reached with GIE set
+  bool Injected;              // had an interrupt injected before it
+} Site_t;
+
+static Site_t Sites[STRESS_MAX_SITES];
+static unsigned SiteCount;
+
+// Where each variable in FW_Shared starts in the byte arrays below
+static size_t SharedBase[STRESS_MAX_SHARED];
+
+// For each byte of the shared variables: one more than the interrupt that
+// last wrote it, or 0 if none has, and the interrupts serviced and mainline
+// access it was on when mainline last loaded it. LoadAccess goes back to 0
+// when mainline stores to it.
+static uint64_t IsrWrote[STRESS_MAX_BYTES];
+static uint64_t LoadSerial[STRESS_MAX_BYTES];
+static uint64_t LoadAccess[STRESS_MAX_BYTES];
+
+static bool Ready;
+
+// Set while a hook is being handled, so the accesses of the firmware.c probes
+// it calls are ignored
+static bool Busy;
+
+static uint32_t PreemptEvery = 1;
+static uint64_t Accesses;
+static uint64_t Points;
+static uint64_t Preemptions;
+
+// The mainline code that made the last access, and what that access loaded,
+// or NULL if it was a store
+static const void *LastSite;
+static const volatile void *LastLoad;
+
+// The LED frames as last seen, and each frame's contents when it was
+// committed, for as long as it stays committed
+static int LastFront;
+static bool LastCommitted;
+static bool Sealed[2];
+static uint8_t Snapshot[2][FW_FRAME_SIZE];
+
+// The interrupt the ISR last brought the frames up to date in
+static uint64_t IsrSettled = UINT64_MAX;
+
+static void Init(void)
+{
+  FwFrames_t Frames;
+  size_t Bytes = 0;
+  int i;
+
+  for (i = 0; FW_Shared[i].Name; i++)
+  {
+    if (i == STRESS_MAX_SHARED)
+    {
+      fprintf(stderr, "too many shared variables\n");
+      abort();
+    }
+    SharedBase[i] = Bytes;
+    Bytes += FW_Shared[i].Size;
+  }
+  if (Bytes > STRESS_MAX_BYTES)
+  {
+    fprintf(stderr, "too many bytes of shared variables\n");
+    abort();
+  }
+  FW_GetFrames(&Frames);
+  LastFront = Frames.Front;
+  LastCommitted = Frames.Committed;
+  Ready = true;
+}
+
+// The shared variable holding the byte at Addr, or -1. *Byte is set to its
+// index in the byte arrays.
+static int FindShared(const volatile void *Addr, size_t *Byte)
+{
+  uintptr_t At = (uintptr_t)Addr;
+
+  for (int i = 0; FW_Shared[i].Name; i++)
+  {
+    uintptr_t Start = (uintptr_t)FW_Shared[i].Addr;
+
+    if ((At >= Start) && (At < Start + FW_Shared[i].Size))
+    {
+      *Byte = SharedBase[i] + (At - Start);
+      return i;
+    }
+  }
+  return -1;
+}
+
+// The entry for Site, added if need be
+static Site_t *FindSite(const void *Site)
+{
+  unsigned i = (unsigned)((uintptr_t)Site * 2654435761u) & (STRESS_MAX_SITES - 1);
+
+  while (Sites[i].Site != Site)
+  {
+    if (!Sites[i].Site)
+    {
+      if (SiteCount == STRESS_MAX_SITES - 1)
+      {
+        fprintf(stderr, "too many mainline sites accessing shared variables\n");
+        abort();
+      }
+      SiteCount++;
+      Sites[i].Site = Site;
+      break;
+    }
+    i = (i + 1) & (STRESS_MAX_SITES - 1);
+  }
+  return &Sites[i];
+}
+
+static void Found(FindingKind_t Kind, const char *Name, const void *Site)
+{
+  // A half-latched frame is the ISR's doing, wherever mainline was at the
+  // time, so only the first place is kept
+  bool AnySite = (Kind == FINDING_HALF_FRAME);
+
+  for (unsigned i = 0; i < FindingCount; i++)
+  {
+    if ((Findings[i].Kind == Kind) && (Findings[i].Name == Name) &&
+        (AnySite || (Findings[i].Site == Site)))
+    {
+      Findings[i].Count++;
+      return;
+    }
+  }
+  if (FindingCount == STRESS_MAX_FINDINGS)
+  {
+    FindingsDropped = true;
+    return;
+  }
+  Findings[FindingCount++] = (Finding_t){Kind, Name, Site, 1, ""};
+}
+
+/* Catch up with what has happened to the LED frames since the last look. The
+ * ISR taking a frame shows as LEDFront moving, and must find it as mainline
+ * committed it. Mainline committing one seals it, and withdrawing it with
+ * BeginLEDFrame unseals it again.
+ */
+static void SettleFrames(const void *Site)
+{
+  FwFrames_t Frames;
+  const volatile uint8_t *Frame;
+  int Back;
+
+  FW_GetFrames(&Frames);
+  if (Frames.Front != LastFront)
+  {
+    Frame = Frames.Frames + Frames.Front * FW_FRAME_SIZE;
+    if (!Sealed[Frames.Front] ||
+        memcmp(Snapshot[Frames.Front], (const void *)Frame, FW_FRAME_SIZE))
+    {
+      Found(FINDING_HALF_FRAME, FrameNames[Frames.Front], Site);
+    }
+    Sealed[0] = false;
+    Sealed[1] = false;
+    LastFront = Frames.Front;
+    LastCommitted = false;
+  }
+
+  Back = 1 - Frames.Front;
+  if (Frames.Committed && !LastCommitted)
+  {
+    Sealed[Back] = true;
+    memcpy(Snapshot[Back], (const void *)(Frames.Frames + Back * FW_FRAME_SIZE), FW_FRAME_SIZE);
+  }
+  else if (!Frames.Committed && LastCommitted)
+  {
+    Sealed[Back] = false;
+  }
+  LastCommitted = Frames.Committed;
+}
+
+// Mainline is about to store Size bytes at Addr
+static void CheckFrameWrite(const volatile void *Addr, size_t Size, const void *Site)
+{
+  FwFrames_t Frames;
+  uintptr_t Start;
+  uintptr_t At = (uintptr_t)Addr;
+  int Frame;
+
+  FW_GetFrames(&Frames);
+  Start = (uintptr_t)Frames.Frames;
+  if ((At + Size <= Start) || (At >= Start + 2 * FW_FRAME_SIZE))
+  {
+    return;
+  }
+  Frame = (At < Start + FW_FRAME_SIZE) ? 0 : 1;
+  if (Frame == Frames.Front)
+  {
+    Found(FINDING_SHOWN_WRITE, FrameNames[Frame], Site);
+  }
+  else if (Sealed[Frame])
+  {
+    Found(FINDING_COMMITTED_WRITE, FrameNames[Frame], Site);
+  }
+}
+
+static void MainlineAccess(const volatile void *Addr, size_t Size, bool Write, const void *Site)
+{
+  const volatile uint8_t *Bytes = Addr;
+  uint8_t Before[STRESS_MAX_LOAD];
+  bool Compare = false;
+  bool Preempt;
+  bool Lost = false;
+  Site_t *At = NULL;
+  size_t Byte;
+  int Var = -1;
+
+  Accesses++;
+  LastSite = Site;
+  SettleFrames(Site);
+  for (size_t i = 0; (i < Size) && (Var < 0); i++)
+  {
+    Var = FindShared(&Bytes[i], &Byte);
+  }
+
+  // A load and store of the same byte in a row, outside the shared variables,
+  // is an SFR bit set or clear, one instruction on the chip
+  Preempt = INTCONbits.GIE && !(Write && (Var < 0) && (Addr == LastLoad));
+  LastLoad = Write ? NULL : Addr;
+  if (Var >= 0)
+  {
+    At = FindSite(Site);
+    At->Open |= Preempt;
+  }
+  if (Preempt && (++Points % PreemptEvery == 0))
+  {
+    if (At)
+    {
+      At->Injected = true;
+    }
+    if (!Write && (Size > 1) && (Size <= STRESS_MAX_LOAD) && (Var >= 0))
+    {
+      memcpy(Before, (const void *)Addr, Size);
+      Compare = true;
+    }
+    Preemptions++;
+    Busy = false;
+    SIM_Preempt();
+    Busy = true;
+    SettleFrames(Site);
+    if (Compare && memcmp(Before, (const void *)Addr, Size))
+    {
+      Found(FINDING_TORN_READ, FW_Shared[Var].Name, Site);
+    }
+  }
+  if (Write)
+  {
+    CheckFrameWrite(Addr, Size, Site);
+  }
+
+  for (size_t i = 0; i < Size; i++)
+  {
+    int At = FindShared(&Bytes[i], &Byte);
+
+    if (At < 0)
+    {
+      continue;
+    }
+    if (!Write)
+    {
+      LoadSerial[Byte] = SIM_Interrupts();
+      LoadAccess[Byte] = Accesses;
+      continue;
+    }
+    if (LoadAccess[Byte] && (Accesses - LoadAccess[Byte] <= STRESS_RMW_WINDOW) &&
+        (IsrWrote[Byte] > LoadSerial[Byte]) && !Lost)
+    {
+      Found(FINDING_LOST_UPDATE, FW_Shared[At].Name, Site);
+      Lost = true;
+    }
+    LoadAccess[Byte] = 0;
+  }
+}
+
+static void InterruptAccess(const volatile void *Addr, size_t Size, bool Write)
+{
+  const volatile uint8_t *Bytes = Addr;
+  size_t Byte;
+
+  // Mainline is stopped for the length of the interrupt, so whatever it did
+  // to the frames is done. What the ISR does to them is picked up when
+  // mainline next runs.
+  if (IsrSettled != SIM_Interrupts())
+  {
+    IsrSettled = SIM_Interrupts();
+    SettleFrames(LastSite);
+  }
+  if (Write)
+  {
+    for (size_t i = 0; i < Size; i++)
+    {
+      if (FindShared(&Bytes[i], &Byte) >= 0)
+      {
+        IsrWrote[Byte] = SIM_Interrupts() + 1;
+      }
+    }
+  }
+}
+
+static void Access(const volatile void *Addr, size_t Size, bool Write, const void *Site)
+{
+  if (Busy)
+  {
+    return;
+  }
+  Busy = true;
+  if (!Ready)
+  {
+    Init();
+  }
+  if (SIM_InInterrupt())
+  {
+    InterruptAccess(Addr, Size, Write);
+  }
+  else if (SIM_InMainline())
+  {
+    MainlineAccess(Addr, Size, Write, Site);
+  }
+  Busy = false;
+}
+
+/*
+  Instrumentation hooks, called before every load and store in firmware.c
+*/
+#define STRESS_HOOKS(Size)                                                    \
+  void __tsan_read##Size(void *Addr)                                          \
+  {                                                                           \
+    Access(Addr, Size, false, __builtin_return_address(0));                   \
+  }                                                                           \
+  void __tsan_write##Size(void *Addr)                                         \
+  {                                                                           \
+    Access(Addr, Size, true, __builtin_return_address(0));                    \
+  }                                                                           \
+  void __tsan_volatile_read##Size(void *Addr)                                 \
+  {                                                                           \
+    Access(Addr, Size, false, __builtin_return_address(0));                   \
+  }                                                                           \
+  void __tsan_volatile_write##Size(void *Addr)                                \
+  {                                                                           \
+    Access(Addr, Size, true, __builtin_return_address(0));                    \
+  }                                                                           \
+  void __tsan_unaligned_read##Size(void *Addr)                                \
+  {                                                                           \
+    Access(Addr, Size, false, __builtin_return_address(0));                   \
+  }                                                                           \
+  void __tsan_unaligned_write##Size(void *Addr)                               \
+  {                                                                           \
+    Access(Addr, Size, true, __builtin_return_address(0));                    \
+  }
+
+STRESS_HOOKS(1)
+STRESS_HOOKS(2)
+STRESS_HOOKS(4)
+STRESS_HOOKS(8)
+STRESS_HOOKS(16)
+
+void __tsan_read_range(void *Addr, unsigned long Size)
+{
+  Access(Addr, Size, false, __builtin_return_address(0));
+}
+
+void __tsan_write_range(void *Addr, unsigned long Size)
+{
+  Access(Addr, Size, true, __builtin_return_address(0));
+}
+
+// Called by the instrumentation at start up, for a runtime there isn't
+void __tsan_init(void)
+{
+}
+
+void STRESS_SetInterval(uint32_t Every)
+{
+  PreemptEvery = Every;
+}
+
+// Write the source line of Site to Text, or its address if addr2line can't
+static void SiteText(const void *Site, char *Text, size_t Length)
+{
+  char Exe[256];
+  char Command[400];
+  char Function[128] = "";
+  char Line[256] = "";
+  ssize_t ExeLength = readlink("/proc/self/exe", Exe, sizeof(Exe) - 1);
+  FILE *Pipe = NULL;
+
+  snprintf(Text, Length, "%p", Site);
+  if (ExeLength <= 0)
+  {
+    return;
+  }
+  Exe[ExeLength] = '\0';
+
+  // Site is a return address, so look up the instruction before it
+  snprintf(Command, sizeof(Command), "addr2line -f -s -e '%s' %p 2>/dev/null", Exe,
+           (const void *)((const char *)Site - 1));
+  Pipe = popen(Command, "r");
+  if (!Pipe)
+  {
+    return;
+  }
+  if (fgets(Function, sizeof(Function), Pipe) && fgets(Line, sizeof(Line), Pipe) &&
+      (Line[0] != '?'))
+  {
+    Function[strcspn(Function, "\n")] = '\0';
+    Line[strcspn(Line, " \n")] = '\0';
+    snprintf(Text, Length, "%s (%s)", Line, Function);
+  }
+  pclose(Pipe);
+}
+
+unsigned STRESS_Report(void)
+{
+  unsigned Problems = 0;
+  unsigned Open = 0;
+  unsigned Injected = 0;
+  unsigned Coverage;
+
+  // Code inlined in several places can put one line at several sites
+  for (unsigned i = 0; i < FindingCount; i++)
+  {
+    SiteText(Findings[i].Site, Findings[i].Where, sizeof(Findings[i].Where));
+    for (unsigned j = 0; j < i; j++)
+    {
+      if ((Findings[j].Kind == Findings[i].Kind) && (Findings[j].Name == Findings[i].Name) &&
+          !strcmp(Findings[j].Where, Findings[i].Where))
+      {
+        Findings[j].Count += Findings[i].Count;
+        Findings[i].Count = 0;
+        break;
+      }
+    }
+    Problems += (Findings[i].Count != 0);
+  }
+
+  for (unsigned i = 0; i < STRESS_MAX_SITES; i++)
+  {
+    Open += Sites[i].Open;
+    Injected += Sites[i].Injected;
+  }
+  Coverage = Open ? Injected * 100 / Open : 0;
+
+  printf("stress test         %llu interrupts injected, %llu of %llu mainline accesses open "
+         "to them\n",
+         (unsigned long long)Preemptions, (unsigned long long)Points,
+         (unsigned long long)Accesses);
+  printf("stress coverage     %u of %u shared variable sites open to interrupts injected at "
+         "(%u%%), %u more only run with GIE clear\n",
+         Injected, Open, Coverage, SiteCount - Open);
+  printf("stress verdict      %u problems%s at %u%% coverage%s\n", Problems,
+         FindingsDropped ? " or more" : "", Coverage,
+         (Coverage < STRESS_MIN_COVERAGE) ? ", under the " STRESS_STR(STRESS_MIN_COVERAGE) "% needed" : "");
+  for (unsigned i = 0; i < FindingCount; i++)
+  {
+    if (Findings[i].Count)
+    {
+      printf("  %-18s %-14s %s, %llu time%s\n", FindingNames[Findings[i].Kind], Findings[i].Name,
+             Findings[i].Where, (unsigned long long)Findings[i].Count,
+             (Findings[i].Count == 1) ? "" : "s");
+    }
+  }
+  return Problems + (Coverage < STRESS_MIN_COVERAGE);
+}
@@ -0,0 +1,64 @@
+/*
+ * Learn To Solder 2019 host simulator
+ *
+ * Interrupt-injection stress test, built by make stress as build/stress/sim.
+ *
+ * firmware.c is compiled with GCC's thread sanitizer instrumentation, which
+ * calls a hook before every load and store the firmware makes. There is no
+ * sanitizer runtime: stress.c provides the hooks itself. Each one that comes
+ * from mainline with GIE set is a point where the chip could take an
+ * interrupt, and there the simulator runs one, as though every enabled timer
+ * had just run out. Every such point is tried, or every --preempt-every'th.
+ * A load and store of the same SFR in a row are one instruction on the chip,
+ * such as BSF, so no interrupt goes between them.
+ *
+ * The shared variables firmware.c lists are then checked for:
+ *
+ * - torn reads: mainline reading more than one byte of one, which the
+ *   interrupt changed, so the chip could have read half of each value
+ * - lost updates: mainline storing to one it loaded a few accesses earlier,
+ *   when the ISR wrote it in between
+ * - half-latched LED frames: the ISR taking a frame that differs from what
+ *   mainline committed, mainline writing a frame after committing it, or
+ *   writing the frame the ISR is showing
+ *
+ * The report gives the share of mainline's code sites that access those
+ * variables with GIE set, and so are open to interrupts, that had one
+ * injected, and fails below STRESS_MIN_COVERAGE. Most accesses are made with
+ * GIE clear, in critical sections such as WaitForEvent's, so a count of
+ * accesses says little about coverage.
+ *
+ * atomic.c is built without the instrumentation, as its accessors are how
+ * the firmware makes such accesses safe. Injected TMR2 interrupts each count
+ * a millisecond, so time as the firmware sees it runs fast.
+ */
+
+#ifndef SIM_STRESS_H
+#define SIM_STRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// True while firmware mainline code is running, as opposed to the ISR or the
+// simulator itself
+bool SIM_InMainline(void);
+
+// True while the firmware's ISR is running
+bool SIM_InInterrupt(void);
+
+// Interrupts serviced so far
+uint64_t SIM_Interrupts(void);
+
+// Raise the flag of every enabled timer interrupt and service them. GIE must
+// be set.
+void SIM_Preempt(void);
+
+// Preempt at every Every'th possible point
+void STRESS_SetInterval(uint32_t Every);
+
+// Print what was found, and how many of the places mainline accesses the
+// shared variables with GIE set had an interrupt injected. Returns the number
+// of distinct problems, counting too few such places as one.
+unsigned STRESS_Report(void);
+
+#endif // SIM_STRESS_H
@@ -0,0 +1,198 @@
+/*
+ * Learn To Solder 2019 host simulator
+ *
+ * Stand-in for the XC8 <xc.h> device header so that main.c and the
+ * mcc_generated_files drivers can be compiled unmodified with a Linux C
+ * compiler. Every special function register used by the firmware is a plain
+ * variable owned by sim.c. Anything the simulator needs to see happen at the
+ * moment it happens (port reads, NOP, SLEEP, software delays) is routed to a
+ * hook in sim.c instead.
+ *
+ * Only the PIC12F1572 registers and bits the firmware actually touches are
+ * provided. Add more here as the firmware grows.
+ */
+
+#ifndef SIM_XC_H
+#define SIM_XC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Compiler keywords and builtins */
+#define __interrupt(...)
+#define NOP()                 SIM_Nop()
+#define CLRWDT()              SIM_ClearWatchdog()
+#define SLEEP()               SIM_Sleep()
+#define di()                  (INTCONbits.GIE = 0)
+#define ei()                  (INTCONbits.GIE = 1)
+#define _delay(x)             SIM_Delay((uint32_t)(x))
+#define __delay_ms(x)         _delay((unsigned long)((x)*(_XTAL_FREQ/4000.0)))
+#define __delay_us(x)         _delay((unsigned long)((x)*(_XTAL_FREQ/4000000.0)))
+
+/* Declare an 8 bit SFR <name> and its <name>bits overlay */
+#define SIM_SFR(name, fields)                                                 \
+  typedef union { struct { fields }; uint8_t reg; } name##bits_t;            \
+  extern volatile name##bits_t name##bits
+
+SIM_SFR(INTCON,
+  uint8_t IOCIF:1; uint8_t INTF:1; uint8_t TMR0IF:1; uint8_t IOCIE:1;
+  uint8_t INTE:1; uint8_t TMR0IE:1; uint8_t PEIE:1; uint8_t GIE:1;);
+#define INTCON                INTCONbits.reg
+
+SIM_SFR(STATUS,
+  uint8_t C:1; uint8_t DC:1; uint8_t Z:1; uint8_t nPD:1; uint8_t nTO:1;);
+#define STATUS                STATUSbits.reg
+
+SIM_SFR(OPTION_REG,
+  uint8_t PS:3; uint8_t PSA:1; uint8_t TMR0SE:1; uint8_t TMR0CS:1;
+  uint8_t INTEDG:1; uint8_t nWPUEN:1;);
+#define OPTION_REG            OPTION_REGbits.reg
+
+extern volatile uint8_t TMR0;
+
+SIM_SFR(PIR1,
+  uint8_t TMR1IF:1; uint8_t TMR2IF:1; uint8_t :2; uint8_t TXIF:1;
+  uint8_t RCIF:1; uint8_t ADIF:1; uint8_t TMR1GIF:1;);
+#define PIR1                  PIR1bits.reg
+
+SIM_SFR(PIE1,
+  uint8_t TMR1IE:1; uint8_t TMR2IE:1; uint8_t :2; uint8_t TXIE:1;
+  uint8_t RCIE:1; uint8_t ADIE:1; uint8_t TMR1GIE:1;);
+#define PIE1                  PIE1bits.reg
+
+SIM_SFR(T2CON,
+  uint8_t T2CKPS:2; uint8_t TMR2ON:1; uint8_t T2OUTPS:4;);
+#define T2CON                 T2CONbits.reg
+
+extern volatile uint8_t TMR2;
+extern volatile uint8_t PR2;
+
+SIM_SFR(LATA,
+  uint8_t LATA0:1; uint8_t LATA1:1; uint8_t LATA2:1; uint8_t :1;
+  uint8_t LATA4:1; uint8_t LATA5:1;);
+#define LATA                  LATAbits.reg
+
+SIM_SFR(TRISA,
+  uint8_t TRISA0:1; uint8_t TRISA1:1; uint8_t TRISA2:1; uint8_t TRISA3:1;
+  uint8_t TRISA4:1; uint8_t TRISA5:1;);
+#define TRISA                 TRISAbits.reg
+
+SIM_SFR(ANSELA,
+  uint8_t ANSA0:1; uint8_t ANSA1:1; uint8_t ANSA2:1; uint8_t :1;
+  uint8_t ANSA4:1;);
+#define ANSELA                ANSELAbits.reg
+
+SIM_SFR(WPUA,
+  uint8_t WPUA0:1; uint8_t WPUA1:1; uint8_t WPUA2:1; uint8_t WPUA3:1;
+  uint8_t WPUA4:1; uint8_t WPUA5:1;);
+#define WPUA                  WPUAbits.reg
+
+SIM_SFR(ODCONA,
+  uint8_t ODA0:1; uint8_t ODA1:1; uint8_t ODA2:1; uint8_t :1;
+  uint8_t ODA4:1; uint8_t ODA5:1;);
+#define ODCONA                ODCONAbits.reg
+
+SIM_SFR(APFCON,
+  uint8_t P1SEL:1; uint8_t P2SEL:1; uint8_t :1; uint8_t T1GSEL:1;
+  uint8_t CWGASEL:1; uint8_t CWGBSEL:1; uint8_t :1; uint8_t RXDTSEL:1;);
+#define APFCON                APFCONbits.reg
+
+SIM_SFR(IOCAP,
+  uint8_t IOCAP0:1; uint8_t IOCAP1:1; uint8_t IOCAP2:1; uint8_t IOCAP3:1;
+  uint8_t IOCAP4:1; uint8_t IOCAP5:1;);
+#define IOCAP                 IOCAPbits.reg
+
+SIM_SFR(IOCAN,
+  uint8_t IOCAN0:1; uint8_t IOCAN1:1; uint8_t IOCAN2:1; uint8_t IOCAN3:1;
+  uint8_t IOCAN4:1; uint8_t IOCAN5:1;);
+#define IOCAN                 IOCANbits.reg
+
+SIM_SFR(IOCAF,
+  uint8_t IOCAF0:1; uint8_t IOCAF1:1; uint8_t IOCAF2:1; uint8_t IOCAF3:1;
+  uint8_t IOCAF4:1; uint8_t IOCAF5:1;);
+#define IOCAF                 IOCAFbits.reg
+
+SIM_SFR(OSCCON,
+  uint8_t SCS:2; uint8_t :1; uint8_t IRCF:4; uint8_t SPLLEN:1;);
+#define OSCCON                OSCCONbits.reg
+
+extern volatile uint8_t OSCTUNE;
+extern volatile uint8_t BORCON;
+
+SIM_SFR(WDTCON,
+  uint8_t SWDTEN:1; uint8_t WDTPS:5;);
+#define WDTCON                WDTCONbits.reg
+
+SIM_SFR(VREGCON,
+  uint8_t VREGPM:1; uint8_t :1;);
+#define VREGCON               VREGCONbits.reg
+
+/* 16 bit PWM modules. The register pairs are 16 bit variables here, with the
+ * L and H halves overlaid on them. */
+#define SIM_PWM(n)                                                            \
+  SIM_SFR(PWM##n##CON,                                                        \
+    uint8_t :2; uint8_t MODE:2; uint8_t POL:1; uint8_t OUT:1; uint8_t OE:1;   \
+    uint8_t EN:1;);                                                           \
+  SIM_SFR(PWM##n##CLKCON, uint8_t CS:2; uint8_t :2; uint8_t PS:3;);           \
+  SIM_SFR(PWM##n##LDCON, uint8_t LDS:2; uint8_t :4; uint8_t LDT:1;            \
+    uint8_t LDA:1;);                                                          \
+  extern volatile uint8_t PWM##n##INTE;                                       \
+  extern volatile uint8_t PWM##n##INTF;                                       \
+  extern volatile uint8_t PWM##n##OFCON;                                      \
+  extern volatile uint16_t PWM##n##PH;                                        \
+  extern volatile uint16_t PWM##n##DC;                                        \
+  extern volatile uint16_t PWM##n##PR
+#define SIM_LOW(reg)          (((volatile uint8_t *)&(reg))[0])
+#define SIM_HIGH(reg)         (((volatile uint8_t *)&(reg))[1])
+
+SIM_PWM(1);
+#define PWM1CON               PWM1CONbits.reg
+#define PWM1CLKCON            PWM1CLKCONbits.reg
+#define PWM1LDCON             PWM1LDCONbits.reg
+#define PWM1PHL               SIM_LOW(PWM1PH)
+#define PWM1PHH               SIM_HIGH(PWM1PH)
+#define PWM1DCL               SIM_LOW(PWM1DC)
+#define PWM1DCH               SIM_HIGH(PWM1DC)
+#define PWM1PRL               SIM_LOW(PWM1PR)
+#define PWM1PRH               SIM_HIGH(PWM1PR)
+
+SIM_PWM(2);
+#define PWM2CON               PWM2CONbits.reg
+#define PWM2CLKCON            PWM2CLKCONbits.reg
+#define PWM2LDCON             PWM2LDCONbits.reg
+#define PWM2PHL               SIM_LOW(PWM2PH)
+#define PWM2PHH               SIM_HIGH(PWM2PH)
+#define PWM2DCL               SIM_LOW(PWM2DC)
+#define PWM2DCH               SIM_HIGH(PWM2DC)
+#define PWM2PRL               SIM_LOW(PWM2PR)
+#define PWM2PRH               SIM_HIGH(PWM2PR)
+
+SIM_PWM(3);
+#define PWM3CON               PWM3CONbits.reg
+#define PWM3CLKCON            PWM3CLKCONbits.reg
+#define PWM3LDCON             PWM3LDCONbits.reg
+#define PWM3PHL               SIM_LOW(PWM3PH)
+#define PWM3PHH               SIM_HIGH(PWM3PH)
+#define PWM3DCL               SIM_LOW(PWM3DC)
+#define PWM3DCH               SIM_HIGH(PWM3DC)
+#define PWM3PRL               SIM_LOW(PWM3PR)
+#define PWM3PRH               SIM_HIGH(PWM3PR)
+
+/*
+ * PORTA is an input register, so every read goes through the simulator. That
+ * lets it present the current button level, and it is also where mainline
+ * code is charged for the time it takes to run.
+ */
+SIM_SFR(PORTA,
+  uint8_t RA0:1; uint8_t RA1:1; uint8_t RA2:1; uint8_t RA3:1;
+  uint8_t RA4:1; uint8_t RA5:1;);
+#define PORTAbits             (*SIM_ReadPORTA())
+#define PORTA                 (SIM_ReadPORTA()->reg)
+
+volatile PORTAbits_t *SIM_ReadPORTA(void);
+void SIM_Sleep(void);
+void SIM_Delay(uint32_t Cycles);
+void SIM_ClearWatchdog(void);
+void SIM_Nop(void);
+
+#endif // SIM_XC_H